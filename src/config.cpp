@@ -34,6 +34,8 @@
 #define PARAM_PREVIEW_OUTPUT_GROUPS "PreviewOutputGroups"
 #define PARAM_TALLY_PROGRAM_ENABLED "TallyProgramEnabled"
 #define PARAM_TALLY_PREVIEW_ENABLED "TallyPreviewEnabled"
+#define PARAM_RECEIVE_WORKER_POOL_ENABLED "ReceiveWorkerPoolEnabled"
+#define PARAM_PRECONNECT_RECEIVERS "PreconnectReceivers"
 #define PARAM_SKIP_UPDATE_VERSION "SkipUpdateVersion"
 
 // App Settings
@@ -218,7 +220,9 @@ Config::Config()
 	  PreviewOutputName("OBS Preview"),
 	  PreviewOutputGroups(""),
 	  TallyProgramEnabled(true),
-	  TallyPreviewEnabled(true)
+	  TallyPreviewEnabled(true),
+	  ReceiveWorkerPoolEnabled(false),
+	  PreconnectReceivers(0)
 {
 	ProcessCommandLine();
 	SetDefaultsToUserStore();
@@ -242,6 +246,10 @@ void Config::SetDefaultsToUserStore()
 
 		config_set_default_bool(obs_config, SECTION_NAME, PARAM_TALLY_PROGRAM_ENABLED, TallyProgramEnabled);
 		config_set_default_bool(obs_config, SECTION_NAME, PARAM_TALLY_PREVIEW_ENABLED, TallyPreviewEnabled);
+
+		config_set_default_bool(obs_config, SECTION_NAME, PARAM_RECEIVE_WORKER_POOL_ENABLED,
+					ReceiveWorkerPoolEnabled);
+		config_set_default_int(obs_config, SECTION_NAME, PARAM_PRECONNECT_RECEIVERS, PreconnectReceivers);
 	}
 }
 
@@ -283,6 +291,10 @@ void Config::Load()
 
 		TallyProgramEnabled = config_get_bool(obs_config, SECTION_NAME, PARAM_TALLY_PROGRAM_ENABLED);
 		TallyPreviewEnabled = config_get_bool(obs_config, SECTION_NAME, PARAM_TALLY_PREVIEW_ENABLED);
+
+		ReceiveWorkerPoolEnabled =
+			config_get_bool(obs_config, SECTION_NAME, PARAM_RECEIVE_WORKER_POOL_ENABLED);
+		PreconnectReceivers = (int)config_get_int(obs_config, SECTION_NAME, PARAM_PRECONNECT_RECEIVERS);
 	}
 }
 
@@ -302,6 +314,9 @@ void Config::Save()
 		config_set_bool(obs_config, SECTION_NAME, PARAM_TALLY_PROGRAM_ENABLED, TallyProgramEnabled);
 		config_set_bool(obs_config, SECTION_NAME, PARAM_TALLY_PREVIEW_ENABLED, TallyPreviewEnabled);
 
+		config_set_bool(obs_config, SECTION_NAME, PARAM_RECEIVE_WORKER_POOL_ENABLED, ReceiveWorkerPoolEnabled);
+		config_set_int(obs_config, SECTION_NAME, PARAM_PRECONNECT_RECEIVERS, PreconnectReceivers);
+
 		config_save(obs_config);
 	}
 }
@@ -38,6 +38,8 @@
  * PreviewOutputName=OBS Preview
  * TallyProgramEnabled=false
  * TallyPreviewEnabled=false
+ * ReceiveWorkerPoolEnabled=false
+ * PreconnectReceivers=0
  * CheckForUpdates=true
  * AutoCheckForUpdates=true
  * MainOutputGroups=
@@ -89,6 +91,9 @@ public:
 	QString PreviewOutputGroups;
 	bool TallyProgramEnabled;
 	bool TallyPreviewEnabled;
+	bool ReceiveWorkerPoolEnabled;
+	// Maximum number of receivers pre-connected for the likely next scene, 0 to disable.
+	int PreconnectReceivers;
 
 	QString GetInstallGUID();
 	bool AutoCheckForUpdates();
@@ -290,6 +290,9 @@ void OutputSettings::onFormAccepted()
 	config->TallyProgramEnabled = ui->tallyProgramCheckBox->isChecked();
 	config->TallyPreviewEnabled = ui->tallyPreviewCheckBox->isChecked();
 
+	config->ReceiveWorkerPoolEnabled = ui->receiveWorkerPoolCheckBox->isChecked();
+	config->PreconnectReceivers = ui->preconnectReceiversSpinBox->value();
+
 	config->AutoCheckForUpdates(ui->checkBoxAutoCheckForUpdates->isChecked());
 
 	auto mainSupported = ui->mainOutputGroupBox->isEnabled();
@@ -362,6 +365,9 @@ void OutputSettings::showEvent(QShowEvent *)
 	ui->tallyProgramCheckBox->setChecked(config->TallyProgramEnabled);
 	ui->tallyPreviewCheckBox->setChecked(config->TallyPreviewEnabled);
 
+	ui->receiveWorkerPoolCheckBox->setChecked(config->ReceiveWorkerPoolEnabled);
+	ui->preconnectReceiversSpinBox->setValue(config->PreconnectReceivers);
+
 	ui->checkBoxAutoCheckForUpdates->setChecked(config->AutoCheckForUpdates());
 }
 
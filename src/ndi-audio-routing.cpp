@@ -0,0 +1,290 @@
+/******************************************************************************
+	Copyright (C) 2016-2024 DistroAV <contact@distroav.org>
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include "ndi-audio-routing.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define NDI_AUDIO_ROUTING_SSE2
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define NDI_AUDIO_ROUTING_NEON
+#endif
+
+// Speaker positions of the standard layouts, in the channel order of the OBS speaker layouts.
+enum ndi_audio_speaker { FL, FR, FC, LFE, RL, RR, SL, SR, RC, SPEAKER_COUNT };
+
+static const std::vector<ndi_audio_speaker> *ndi_audio_layout(int channels)
+{
+	static const std::vector<ndi_audio_speaker> layouts[] = {
+		{},
+		{FC},
+		{FL, FR},
+		{FL, FR, LFE},
+		{FL, FR, FC, RC},
+		{FL, FR, FC, LFE, RC},
+		{FL, FR, FC, LFE, RL, RR},
+		{},
+		{FL, FR, FC, LFE, RL, RR, SL, SR},
+	};
+	if (channels < 1 || channels > 8 || layouts[channels].empty())
+		return nullptr;
+	return &layouts[channels];
+}
+
+//
+// Adds the gains of `speaker` onto the speakers of the output layout (`present`) to `gains`.
+// Missing speakers fold onto their neighbors: center to front left and right at -3 dB, side and rear
+// surrounds onto each other or onto the front at -3 dB, rear center onto the surrounds or the front, front left
+// and right onto the center (mono) at -6 dB. LFE is dropped when the output has none.
+//
+static void ndi_audio_fold(ndi_audio_speaker speaker, float gain, const bool present[SPEAKER_COUNT],
+			   float gains[SPEAKER_COUNT])
+{
+	const float minus_3db = 0.70710678f;
+	if (present[speaker]) {
+		gains[speaker] += gain;
+		return;
+	}
+
+	switch (speaker) {
+	case FL:
+	case FR:
+		if (present[FC])
+			ndi_audio_fold(FC, gain * 0.5f, present, gains);
+		break;
+	case FC:
+		ndi_audio_fold(FL, gain * minus_3db, present, gains);
+		ndi_audio_fold(FR, gain * minus_3db, present, gains);
+		break;
+	case SL:
+	case RL:
+		if (present[speaker == SL ? RL : SL])
+			gains[speaker == SL ? RL : SL] += gain;
+		else
+			ndi_audio_fold(FL, gain * minus_3db, present, gains);
+		break;
+	case SR:
+	case RR:
+		if (present[speaker == SR ? RR : SR])
+			gains[speaker == SR ? RR : SR] += gain;
+		else
+			ndi_audio_fold(FR, gain * minus_3db, present, gains);
+		break;
+	case RC:
+		if (present[RL] || present[SL]) {
+			ndi_audio_fold(RL, gain * minus_3db, present, gains);
+			ndi_audio_fold(RR, gain * minus_3db, present, gains);
+		} else {
+			ndi_audio_fold(FL, gain * 0.5f, present, gains);
+			ndi_audio_fold(FR, gain * 0.5f, present, gains);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+//
+// Builds the downmix matrix between two standard layouts. Returns false if either layout is not standard.
+//
+static bool ndi_audio_routing_standard_downmix(ndi_audio_routing_t *routing, int input_channels,
+					       int output_channels)
+{
+	auto inputs = ndi_audio_layout(input_channels);
+	auto outputs = ndi_audio_layout(output_channels);
+	if (!inputs || !outputs)
+		return false;
+
+	bool present[SPEAKER_COUNT] = {};
+	for (auto speaker : *outputs)
+		present[speaker] = true;
+
+	std::vector<std::vector<float>> matrix(output_channels, std::vector<float>(input_channels, 0.0f));
+	for (int input = 0; input < input_channels; ++input) {
+		float gains[SPEAKER_COUNT] = {};
+		ndi_audio_fold((*inputs)[input], 1.0f, present, gains);
+		for (int output = 0; output < output_channels; ++output)
+			matrix[output][input] = gains[(*outputs)[output]];
+	}
+
+	// Scale the matrix so that no output can clip more than its inputs.
+	float max_sum = 1.0f;
+	for (auto &row : matrix) {
+		float sum = 0.0f;
+		for (float gain : row)
+			sum += gain;
+		max_sum = std::max(max_sum, sum);
+	}
+	for (int output = 0; output < output_channels; ++output) {
+		for (int input = 0; input < input_channels; ++input) {
+			if (matrix[output][input] > 0.0f)
+				routing->routes[output].push_back({input, matrix[output][input] / max_sum});
+		}
+	}
+	return true;
+}
+
+bool ndi_audio_routing_parse_map(const char *text, std::vector<std::vector<int>> &map)
+{
+	map.clear();
+	if (!text) {
+		return false;
+	}
+
+	std::vector<int> output;
+	const char *p = text;
+	while (true) {
+		while (*p == ' ')
+			++p;
+		char *end = nullptr;
+		const long channel = strtol(p, &end, 10);
+		if (end == p || channel < 1 || channel > 1024) {
+			map.clear();
+			return false;
+		}
+		output.push_back((int)channel - 1);
+		p = end;
+		while (*p == ' ')
+			++p;
+
+		if (*p == '+') {
+			++p;
+			continue;
+		}
+		map.push_back(output);
+		output.clear();
+		if (*p == ',' && map.size() < NDI_AUDIO_ROUTING_MAX_OUTPUTS) {
+			++p;
+			continue;
+		}
+		if (*p != '\0') {
+			map.clear();
+			return false;
+		}
+		return true;
+	}
+}
+
+void ndi_audio_routing_configure(ndi_audio_routing_t *routing, int mode, const std::vector<std::vector<int>> &map)
+{
+	routing->mode = mode;
+	routing->map = map;
+	routing->input_channels = 0;
+	routing->output_channels = 0;
+	routing->routes.clear();
+}
+
+bool ndi_audio_routing_prepare(ndi_audio_routing_t *routing, int input_channels, int output_channels)
+{
+	if (routing->mode == NDI_AUDIO_ROUTING_FIRST_CHANNELS ||
+	    (routing->mode == NDI_AUDIO_ROUTING_MAP && routing->map.empty())) {
+		return false;
+	}
+	if (routing->mode == NDI_AUDIO_ROUTING_MAP) {
+		output_channels = (int)routing->map.size();
+	}
+	output_channels = std::clamp(output_channels, 1, NDI_AUDIO_ROUTING_MAX_OUTPUTS);
+
+	if (routing->input_channels == input_channels && routing->output_channels == output_channels) {
+		return true;
+	}
+
+	routing->input_channels = input_channels;
+	routing->output_channels = output_channels;
+	routing->routes.assign(output_channels, {});
+
+	if (routing->mode == NDI_AUDIO_ROUTING_DOWNMIX &&
+	    ndi_audio_routing_standard_downmix(routing, input_channels, output_channels)) {
+		return true;
+	} else if (routing->mode == NDI_AUDIO_ROUTING_DOWNMIX) {
+		for (int input = 0; input < input_channels; ++input) {
+			routing->routes[input % output_channels].push_back({input, 1.0f});
+		}
+		// Average the inputs folded onto each output so that the mix cannot clip more than its inputs.
+		for (auto &routes : routing->routes) {
+			for (auto &route : routes) {
+				route.gain = 1.0f / (float)routes.size();
+			}
+		}
+	} else {
+		for (int output = 0; output < output_channels; ++output) {
+			for (int input : routing->map[output]) {
+				// Channels the NDI source does not send are ignored (silent).
+				if (input < input_channels)
+					routing->routes[output].push_back({input, 1.0f});
+			}
+		}
+	}
+	return true;
+}
+
+//
+// dst = src * gain (accumulate = false) or dst += src * gain (accumulate = true), over planar float samples.
+//
+static void ndi_audio_mix(float *dst, const float *src, float gain, size_t count, bool accumulate)
+{
+	size_t i = 0;
+#if defined(NDI_AUDIO_ROUTING_SSE2)
+	const __m128 g = _mm_set1_ps(gain);
+	if (accumulate) {
+		for (; i + 4 <= count; i += 4) {
+			_mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(_mm_loadu_ps(src + i), g)));
+		}
+	} else {
+		for (; i + 4 <= count; i += 4) {
+			_mm_storeu_ps(dst + i, _mm_mul_ps(_mm_loadu_ps(src + i), g));
+		}
+	}
+#elif defined(NDI_AUDIO_ROUTING_NEON)
+	if (accumulate) {
+		for (; i + 4 <= count; i += 4) {
+			vst1q_f32(dst + i, vmlaq_n_f32(vld1q_f32(dst + i), vld1q_f32(src + i), gain));
+		}
+	} else {
+		for (; i + 4 <= count; i += 4) {
+			vst1q_f32(dst + i, vmulq_n_f32(vld1q_f32(src + i), gain));
+		}
+	}
+#endif
+	for (; i < count; ++i) {
+		dst[i] = accumulate ? dst[i] + src[i] * gain : src[i] * gain;
+	}
+}
+
+void ndi_audio_routing_apply(ndi_audio_routing_t *routing, const uint8_t *data, int channel_stride_in_bytes,
+			     int samples, const uint8_t *outputs[NDI_AUDIO_ROUTING_MAX_OUTPUTS])
+{
+	const size_t count = (size_t)std::max(samples, 0);
+	routing->buffer.resize(count * routing->output_channels);
+
+	for (int output = 0; output < routing->output_channels; ++output) {
+		float *dst = routing->buffer.data() + output * count;
+		const auto &routes = routing->routes[output];
+		if (routes.empty()) {
+			std::fill(dst, dst + count, 0.0f);
+		}
+		for (size_t r = 0; r < routes.size(); ++r) {
+			auto src = (const float *)(data + (size_t)routes[r].input * channel_stride_in_bytes);
+			ndi_audio_mix(dst, src, routes[r].gain, count, r > 0);
+		}
+		outputs[output] = (const uint8_t *)dst;
+	}
+}
@@ -0,0 +1,71 @@
+/******************************************************************************
+	Copyright (C) 2016-2024 DistroAV <contact@distroav.org>
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#define NDI_AUDIO_ROUTING_FIRST_CHANNELS 0
+#define NDI_AUDIO_ROUTING_DOWNMIX 1
+#define NDI_AUDIO_ROUTING_MAP 2
+
+// OBS sources carry at most 8 audio channels.
+#define NDI_AUDIO_ROUTING_MAX_OUTPUTS 8
+
+typedef struct ndi_audio_route_t {
+	int input;
+	float gain;
+} ndi_audio_route_t;
+
+//
+// Channel routing matrix of an NDI source: maps the (possibly many) channels of the NDI audio frames to the
+// channels of the OBS source.
+// - NDI_AUDIO_ROUTING_FIRST_CHANNELS: the first 8 channels are passed through, the others are dropped.
+// - NDI_AUDIO_ROUTING_DOWNMIX: every channel is mixed into the OBS speaker layout. Standard layouts (mono,
+//   stereo, 2.1, 4.0, 4.1, 5.1 and 7.1, told apart by their channel count as in OBS) use ITU-R BS.775 style
+//   coefficients; other channel counts are folded with input `i` going to output `i % outputs`.
+// - NDI_AUDIO_ROUTING_MAP: each OBS channel is the sum of a list of NDI channels, e.g. "1+3,2+4" for a stereo
+//   mix of the channels 1 to 4.
+//
+typedef struct ndi_audio_routing_t {
+	int mode;
+	// NDI_AUDIO_ROUTING_MAP: 0-based input channels of each output channel.
+	std::vector<std::vector<int>> map;
+
+	// Matrix built for this frame layout (see `ndi_audio_routing_prepare`).
+	int input_channels;
+	int output_channels;
+	std::vector<std::vector<ndi_audio_route_t>> routes;
+
+	// Planar output samples.
+	std::vector<float> buffer;
+} ndi_audio_routing_t;
+
+// Parses a channel map such as "1+3,2+4" (1-based channel numbers). Returns false if the text is malformed.
+bool ndi_audio_routing_parse_map(const char *text, std::vector<std::vector<int>> &map);
+
+// Sets the routing mode and map. The matrix is rebuilt on the next frame.
+void ndi_audio_routing_configure(ndi_audio_routing_t *routing, int mode, const std::vector<std::vector<int>> &map);
+
+// Returns true if the frames must go through `ndi_audio_routing_apply`, false if they can be passed through.
+bool ndi_audio_routing_prepare(ndi_audio_routing_t *routing, int input_channels, int output_channels);
+
+// Routes `samples` samples of the planar float NDI frame to `routing->buffer`; `outputs` receives the planes.
+void ndi_audio_routing_apply(ndi_audio_routing_t *routing, const uint8_t *data, int channel_stride_in_bytes,
+			     int samples, const uint8_t *outputs[NDI_AUDIO_ROUTING_MAX_OUTPUTS]);
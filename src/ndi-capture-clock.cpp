@@ -0,0 +1,135 @@
+/******************************************************************************
+	Copyright (C) 2016-2024 DistroAV <contact@distroav.org>
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include "ndi-capture-clock.h"
+
+#include "plugin-main.h"
+
+#include <util/platform.h>
+#include <util/threading.h>
+
+#include <algorithm>
+
+std::vector<NDICaptureClock::Subscriber> NDICaptureClock::subscribers;
+std::thread NDICaptureClock::clockThread;
+std::mutex NDICaptureClock::subscribersMutex;
+std::condition_variable NDICaptureClock::subscribersChanged;
+bool NDICaptureClock::stopping = false;
+
+void NDICaptureClock::Add(void *param, CaptureFunction capture, OutputFunction output)
+{
+	std::lock_guard<std::mutex> lock(subscribersMutex);
+
+	if (!clockThread.joinable()) {
+		stopping = false;
+		clockThread = std::thread(ClockLoop);
+		obs_log(LOG_INFO, "NDICaptureClock: started capture clock thread");
+	}
+
+	subscribers.push_back({param, capture, output});
+	obs_log(LOG_DEBUG, "NDICaptureClock::Add: %zu genlocked sources", subscribers.size());
+	subscribersChanged.notify_one();
+}
+
+void NDICaptureClock::Remove(void *param)
+{
+	// The clock thread holds the lock for the whole tick.
+	std::lock_guard<std::mutex> lock(subscribersMutex);
+
+	auto it = std::find_if(subscribers.begin(), subscribers.end(),
+			       [param](const Subscriber &subscriber) { return subscriber.param == param; });
+	if (it == subscribers.end()) {
+		return;
+	}
+
+	subscribers.erase(it);
+	obs_log(LOG_DEBUG, "NDICaptureClock::Remove: %zu genlocked sources", subscribers.size());
+}
+
+void NDICaptureClock::Shutdown()
+{
+	{
+		std::lock_guard<std::mutex> lock(subscribersMutex);
+		stopping = true;
+		subscribersChanged.notify_all();
+	}
+
+	if (clockThread.joinable()) {
+		clockThread.join();
+	}
+
+	std::lock_guard<std::mutex> lock(subscribersMutex);
+	subscribers.clear();
+}
+
+//
+// Returns the first OBS frame boundary after both now and the previous tick.
+// obs_get_video_frame_time() is the time of the frame OBS last rendered, which gives the phase of the ticks.
+//
+uint64_t NDICaptureClock::NextTick(uint64_t last_tick_ns, uint64_t interval_ns)
+{
+	const uint64_t now = os_gettime_ns();
+	const uint64_t frame_time_ns = obs_get_video_frame_time();
+
+	uint64_t tick_ns = now;
+	if (frame_time_ns > now) {
+		tick_ns = frame_time_ns;
+	} else if (frame_time_ns > 0) {
+		tick_ns = frame_time_ns + ((now - frame_time_ns) / interval_ns + 1) * interval_ns;
+	}
+
+	// Never tick twice for the same frame, e.g. when the phase of the OBS frames shifted slightly.
+	if (last_tick_ns && tick_ns < last_tick_ns + interval_ns / 2) {
+		tick_ns += interval_ns;
+	}
+	return tick_ns;
+}
+
+void NDICaptureClock::ClockLoop()
+{
+	os_set_thread_name("distroav-ndi-capture-clock");
+
+	uint64_t last_tick_ns = 0;
+	std::unique_lock<std::mutex> lock(subscribersMutex);
+	while (!stopping) {
+		if (subscribers.empty()) {
+			last_tick_ns = 0;
+			subscribersChanged.wait(lock);
+			continue;
+		}
+
+		obs_video_info ovi;
+		uint64_t interval_ns = 1000000000ULL / 30;
+		if (obs_get_video_info(&ovi) && ovi.fps_num > 0 && ovi.fps_den > 0) {
+			interval_ns = (uint64_t)ovi.fps_den * 1000000000ULL / (uint64_t)ovi.fps_num;
+		}
+
+		last_tick_ns = NextTick(last_tick_ns, interval_ns);
+		lock.unlock();
+		os_sleepto_ns(last_tick_ns);
+		lock.lock();
+
+		// Capture everything first so that all the sources are sampled at the same instant...
+		for (auto &subscriber : subscribers) {
+			subscriber.capture(subscriber.param, interval_ns);
+		}
+		// ...then do the (slower) conversion and output to OBS.
+		for (auto &subscriber : subscribers) {
+			subscriber.output(subscriber.param);
+		}
+	}
+}
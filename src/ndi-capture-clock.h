@@ -0,0 +1,60 @@
+/******************************************************************************
+	Copyright (C) 2016-2024 DistroAV <contact@distroav.org>
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Shared capture clock for genlocked FrameSync sources.
+ *
+ * A single thread ticks once per OBS video frame, aligned on the OBS frame time. On every tick, all the
+ * subscribed sources capture their FrameSync first, then output what they captured: every source is sampled at
+ * (nearly) the same instant, and the whole group costs one wakeup per frame instead of one per source.
+ */
+class NDICaptureClock {
+public:
+	// Pulls one frame interval (`interval_ns`) worth of media from the FrameSync, without outputting it.
+	using CaptureFunction = void (*)(void *param, uint64_t interval_ns);
+	// Outputs (and releases) what the last capture pulled.
+	using OutputFunction = void (*)(void *param);
+
+	static void Add(void *param, CaptureFunction capture, OutputFunction output);
+	// Blocks until a tick in progress has completed, then unregisters the subscriber.
+	static void Remove(void *param);
+	static void Shutdown();
+
+private:
+	struct Subscriber {
+		void *param;
+		CaptureFunction capture;
+		OutputFunction output;
+	};
+
+	static std::vector<Subscriber> subscribers;
+	static std::thread clockThread;
+	static std::mutex subscribersMutex;
+	static std::condition_variable subscribersChanged;
+	static bool stopping;
+
+	static uint64_t NextTick(uint64_t last_tick_ns, uint64_t interval_ns);
+	static void ClockLoop();
+};
@@ -1,10 +1,20 @@
 #include "ndi-finder.h"
 
+#include <util/threading.h>
+
+#include <algorithm>
+
 std::vector<std::string> NDIFinder::NDISourceList;
 std::chrono::time_point<std::chrono::steady_clock> NDIFinder::lastRefreshTime;
 std::mutex NDIFinder::listMutex;
 bool NDIFinder::isRefreshing = false;
 
+std::vector<NDIFinder::PresenceWatch> NDIFinder::presenceWatches;
+std::mutex NDIFinder::presenceMutex;
+std::condition_variable NDIFinder::presenceChanged;
+std::thread NDIFinder::presenceThread;
+bool NDIFinder::presenceStopping = false;
+
 std::vector<std::string> NDIFinder::getNDISourceList(Callback callback)
 {
 	std::lock_guard<std::mutex> lock(listMutex);
@@ -65,3 +75,99 @@ void NDIFinder::retrieveNDISourceList()
 
 	ndiLib->find_destroy(ndi_find);
 }
+
+void NDIFinder::watchPresence(void *param, const char *ndiName, PresenceCallback callback)
+{
+	if (!ndiName) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(presenceMutex);
+
+	auto it = std::find_if(presenceWatches.begin(), presenceWatches.end(),
+			       [param](const PresenceWatch &watch) { return watch.param == param; });
+	if (it != presenceWatches.end()) {
+		*it = {param, ndiName, callback, false};
+	} else {
+		presenceWatches.push_back({param, ndiName, callback, false});
+	}
+
+	if (!presenceThread.joinable()) {
+		presenceStopping = false;
+		presenceThread = std::thread(presenceLoop);
+	}
+	presenceChanged.notify_one();
+}
+
+void NDIFinder::unwatchPresence(void *param)
+{
+	// Callbacks run with the lock held: once it is acquired, none is running for `param`.
+	std::lock_guard<std::mutex> lock(presenceMutex);
+	presenceWatches.erase(std::remove_if(presenceWatches.begin(), presenceWatches.end(),
+					     [param](const PresenceWatch &watch) { return watch.param == param; }),
+			      presenceWatches.end());
+}
+
+void NDIFinder::shutdown()
+{
+	{
+		std::lock_guard<std::mutex> lock(presenceMutex);
+		presenceStopping = true;
+		presenceChanged.notify_all();
+	}
+
+	if (presenceThread.joinable()) {
+		presenceThread.join();
+	}
+}
+
+//
+// Keeps an NDI finder open while sources are waiting for their sender to come back online, and calls their
+// callback when the sender is announced again (or no longer), instead of having every disconnected source poll
+// its receiver.
+//
+void NDIFinder::presenceLoop()
+{
+	os_set_thread_name("distroav-ndi-presence");
+
+	std::unique_lock<std::mutex> lock(presenceMutex);
+	while (!presenceStopping) {
+		if (presenceWatches.empty() || !ndiLib) {
+			presenceChanged.wait(lock);
+			continue;
+		}
+
+		NDIlib_find_create_t find_desc = {0};
+		find_desc.show_local_sources = true;
+		find_desc.p_groups = NULL;
+		NDIlib_find_instance_t ndi_find = ndiLib->find_create_v2(&find_desc);
+		if (!ndi_find) {
+			// Disconnected sources fall back to their reconnection backoff.
+			presenceChanged.wait(lock);
+			continue;
+		}
+
+		while (!presenceStopping && !presenceWatches.empty()) {
+			lock.unlock();
+			ndiLib->find_wait_for_sources(ndi_find, 1000);
+			uint32_t n_sources = 0;
+			const NDIlib_source_t *sources = ndiLib->find_get_current_sources(ndi_find, &n_sources);
+			lock.lock();
+
+			for (auto &watch : presenceWatches) {
+				bool online = false;
+				for (uint32_t i = 0; i < n_sources && !online; ++i) {
+					online = sources[i].p_ndi_name && watch.ndiName == sources[i].p_ndi_name;
+				}
+				if (online != watch.online) {
+					watch.callback(watch.param, online);
+				}
+				watch.online = online;
+			}
+		}
+
+		lock.unlock();
+		ndiLib->find_destroy(ndi_find);
+		lock.lock();
+	}
+}
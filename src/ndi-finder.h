@@ -6,6 +6,7 @@
 #include <mutex>
 #include <functional>
 #include <chrono>
+#include <condition_variable>
 #include <Processing.NDI.Lib.h>
 
 class NDIFinder {
@@ -13,7 +14,29 @@ public:
 	using Callback = std::function<void(void *)>;
 	static std::vector<std::string> getNDISourceList(Callback callback);
 
+	// Called on the presence watcher thread when a watched NDI source is announced on the network (`online`) or
+	// is no longer announced. Must return quickly: it runs with the watch list locked.
+	using PresenceCallback = void (*)(void *param, bool online);
+	static void watchPresence(void *param, const char *ndiName, PresenceCallback callback);
+	// Blocks until a running callback for `param` has returned.
+	static void unwatchPresence(void *param);
+	static void shutdown();
+
 private:
+	struct PresenceWatch {
+		void *param;
+		std::string ndiName;
+		PresenceCallback callback;
+		bool online;
+	};
+
+	static std::vector<PresenceWatch> presenceWatches;
+	static std::mutex presenceMutex;
+	static std::condition_variable presenceChanged;
+	static std::thread presenceThread;
+	static bool presenceStopping;
+	static void presenceLoop();
+
 	static std::vector<std::string> NDISourceList;
 	static std::chrono::time_point<std::chrono::steady_clock> lastRefreshTime;
 	static std::mutex listMutex;
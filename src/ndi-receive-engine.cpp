@@ -0,0 +1,168 @@
+/******************************************************************************
+	Copyright (C) 2016-2024 DistroAV <contact@distroav.org>
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include "ndi-receive-engine.h"
+
+#include "plugin-main.h"
+
+#include <util/platform.h>
+#include <util/threading.h>
+
+#include <algorithm>
+#include <chrono>
+
+std::vector<NDIReceiveEngine::Task *> NDIReceiveEngine::tasks;
+std::vector<std::thread> NDIReceiveEngine::workers;
+std::mutex NDIReceiveEngine::tasksMutex;
+std::condition_variable NDIReceiveEngine::tasksChanged;
+std::condition_variable NDIReceiveEngine::taskStepped;
+uint64_t NDIReceiveEngine::timekeeperDeadline = 0;
+bool NDIReceiveEngine::stopping = false;
+
+void NDIReceiveEngine::Add(void *param, StepFunction step)
+{
+	std::lock_guard<std::mutex> lock(tasksMutex);
+
+	if (workers.empty()) {
+		stopping = false;
+		auto worker_count = std::max(1, os_get_logical_cores());
+		for (int i = 0; i < worker_count; ++i) {
+			workers.emplace_back(WorkerLoop);
+		}
+		obs_log(LOG_INFO, "NDIReceiveEngine: started %d receive worker threads", worker_count);
+	}
+
+	tasks.push_back(new Task{param, step, 0, false, false, false});
+	obs_log(LOG_DEBUG, "NDIReceiveEngine::Add: %zu tasks scheduled", tasks.size());
+	tasksChanged.notify_one();
+}
+
+void NDIReceiveEngine::Remove(void *param)
+{
+	std::unique_lock<std::mutex> lock(tasksMutex);
+
+	auto it = std::find_if(tasks.begin(), tasks.end(), [param](Task *task) { return task->param == param; });
+	if (it == tasks.end()) {
+		return;
+	}
+
+	auto task = *it;
+	// Prevent the task from being picked up again, then wait for a running step to complete.
+	task->stopped = true;
+	taskStepped.wait(lock, [task] { return !task->running; });
+
+	tasks.erase(std::find(tasks.begin(), tasks.end(), task));
+	delete task;
+	obs_log(LOG_DEBUG, "NDIReceiveEngine::Remove: %zu tasks scheduled", tasks.size());
+}
+
+void NDIReceiveEngine::Wake(void *param)
+{
+	std::lock_guard<std::mutex> lock(tasksMutex);
+
+	for (auto task : tasks) {
+		if (task->param == param) {
+			// A running step would overwrite next_run_ns when it completes.
+			task->wake_requested = task->running;
+			task->next_run_ns = 0;
+			tasksChanged.notify_one();
+			break;
+		}
+	}
+}
+
+void NDIReceiveEngine::Shutdown()
+{
+	{
+		std::lock_guard<std::mutex> lock(tasksMutex);
+		stopping = true;
+		tasksChanged.notify_all();
+	}
+
+	for (auto &worker : workers) {
+		worker.join();
+	}
+
+	std::lock_guard<std::mutex> lock(tasksMutex);
+	workers.clear();
+	for (auto task : tasks) {
+		delete task;
+	}
+	tasks.clear();
+}
+
+NDIReceiveEngine::Task *NDIReceiveEngine::NextTask()
+{
+	Task *next = nullptr;
+	for (auto task : tasks) {
+		if (task->running || task->stopped) {
+			continue;
+		}
+		if (!next || task->next_run_ns < next->next_run_ns) {
+			next = task;
+		}
+	}
+	return next;
+}
+
+void NDIReceiveEngine::WorkerLoop()
+{
+	os_set_thread_name("distroav-ndi-receive");
+
+	std::unique_lock<std::mutex> lock(tasksMutex);
+	while (!stopping) {
+		auto task = NextTask();
+		if (!task) {
+			tasksChanged.wait(lock);
+			continue;
+		}
+
+		auto now = os_gettime_ns();
+		if (task->next_run_ns > now) {
+			if (timekeeperDeadline != 0 && timekeeperDeadline <= task->next_run_ns) {
+				// Another worker is already sleeping until this deadline.
+				tasksChanged.wait(lock);
+			} else {
+				timekeeperDeadline = task->next_run_ns;
+				tasksChanged.wait_for(lock, std::chrono::nanoseconds(task->next_run_ns - now));
+				timekeeperDeadline = 0;
+			}
+			continue;
+		}
+
+		task->running = true;
+		if (timekeeperDeadline == 0) {
+			// Hand the role of waiting for the next deadline to an idle worker.
+			tasksChanged.notify_one();
+		}
+		lock.unlock();
+
+		uint64_t next_run_ns = 0;
+		bool keep_running = task->step(task->param, &next_run_ns);
+
+		lock.lock();
+		task->running = false;
+		task->stopped |= !keep_running;
+		// "As soon as possible" is queued behind the tasks that are already due, so that a busy
+		// source cannot starve the others.
+		task->next_run_ns = (next_run_ns && !task->wake_requested) ? next_run_ns : os_gettime_ns();
+		task->wake_requested = false;
+		if (task->stopped) {
+			taskStepped.notify_all();
+		}
+	}
+}
@@ -0,0 +1,67 @@
+/******************************************************************************
+	Copyright (C) 2016-2024 DistroAV <contact@distroav.org>
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Optional receive engine that multiplexes the receive loops of many NDI sources over a fixed pool of worker
+ * threads (one per logical core) instead of one dedicated thread per source.
+ *
+ * A task is a non-blocking "step" function: it runs one receive iteration using zero-timeout captures and
+ * reports the absolute time (`os_gettime_ns` domain) at which it wants to run again, 0 meaning "as soon as
+ * possible". Workers always run the task that is due the earliest; only one of them sleeps until the next
+ * deadline while the others wait to be notified.
+ */
+class NDIReceiveEngine {
+public:
+	// Returns false to stop scheduling the task (it stays registered until `Remove`).
+	using StepFunction = bool (*)(void *param, uint64_t *next_run_ns);
+
+	static void Add(void *param, StepFunction step);
+	// Blocks until the task is not running on any worker, then unregisters it.
+	static void Remove(void *param);
+	// Makes the task due immediately.
+	static void Wake(void *param);
+	static void Shutdown();
+
+private:
+	struct Task {
+		void *param;
+		StepFunction step;
+		uint64_t next_run_ns;
+		bool running;
+		bool stopped;
+		bool wake_requested;
+	};
+
+	static std::vector<Task *> tasks;
+	static std::vector<std::thread> workers;
+	static std::mutex tasksMutex;
+	static std::condition_variable tasksChanged;
+	static std::condition_variable taskStepped;
+	static uint64_t timekeeperDeadline;
+	static bool stopping;
+
+	static Task *NextTask();
+	static void WorkerLoop();
+};
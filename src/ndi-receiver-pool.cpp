@@ -0,0 +1,256 @@
+/******************************************************************************
+	Copyright (C) 2016-2024 DistroAV <contact@distroav.org>
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include "ndi-receiver-pool.h"
+
+#include <algorithm>
+
+struct NDIReceiverPool::Entry {
+	NDIReceiverKey key;
+	NDIlib_recv_instance_t receiver = nullptr;
+	// subscribers[0] is the capturer
+	std::vector<void *> subscribers;
+	// Subscribers that did not commit their switch to this receiver yet, see `Activate`.
+	std::vector<void *> pendingSubscribers;
+	std::mutex subscribersMutex;
+};
+
+std::map<NDIReceiverKey, NDIReceiverPool::Entry *> NDIReceiverPool::entries;
+std::mutex NDIReceiverPool::entriesMutex;
+
+std::multimap<NDIReceiverKey, NDIlib_recv_instance_t> NDIReceiverPool::parked;
+std::mutex NDIReceiverPool::parkedMutex;
+bool NDIReceiverPool::parking = false;
+
+NDIReceiverPool::Entry *NDIReceiverPool::Acquire(const NDIlib_recv_create_v3_t &recv_desc, bool hw_accel,
+						 void *subscriber, bool pending)
+{
+	if (!ndiLib || !recv_desc.source_to_connect_to.p_ndi_name) {
+		return nullptr;
+	}
+
+	NDIReceiverKey key = {recv_desc.source_to_connect_to.p_ndi_name, recv_desc.bandwidth, recv_desc.color_format,
+			      hw_accel, ""};
+
+	std::lock_guard<std::mutex> lock(entriesMutex);
+
+	auto it = entries.find(key);
+	if (it != entries.end()) {
+		auto entry = it->second;
+		std::lock_guard<std::mutex> subscribersLock(entry->subscribersMutex);
+		(pending ? entry->pendingSubscribers : entry->subscribers).push_back(subscriber);
+		obs_log(LOG_DEBUG, "NDIReceiverPool::Acquire: '%s' (bw=%d, color_format=%d) shared by %zu sources",
+			key.ndi_source_name.c_str(), key.bandwidth, key.color_format,
+			entry->subscribers.size() + entry->pendingSubscribers.size());
+		return entry;
+	}
+
+	auto receiver = Unpark(key);
+	if (!receiver) {
+		receiver = ndiLib->recv_create_v3(&recv_desc);
+	}
+	if (!receiver) {
+		return nullptr;
+	}
+
+	auto entry = new Entry();
+	entry->key = key;
+	entry->receiver = receiver;
+	(pending ? entry->pendingSubscribers : entry->subscribers).push_back(subscriber);
+	entries[key] = entry;
+
+	obs_log(LOG_DEBUG, "NDIReceiverPool::Acquire: '%s' (bw=%d, color_format=%d) created shared receiver",
+		key.ndi_source_name.c_str(), key.bandwidth, key.color_format);
+	return entry;
+}
+
+void NDIReceiverPool::Activate(Entry *entry, void *subscriber)
+{
+	if (!entry) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(entry->subscribersMutex);
+	auto &pending = entry->pendingSubscribers;
+	auto it = std::find(pending.begin(), pending.end(), subscriber);
+	if (it != pending.end()) {
+		pending.erase(it);
+		entry->subscribers.push_back(subscriber);
+	}
+}
+
+void NDIReceiverPool::Release(Entry *entry, void *subscriber)
+{
+	if (!entry) {
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(entriesMutex);
+		std::lock_guard<std::mutex> subscribersLock(entry->subscribersMutex);
+
+		auto &subscribers = entry->subscribers;
+		subscribers.erase(std::remove(subscribers.begin(), subscribers.end(), subscriber), subscribers.end());
+		auto &pending = entry->pendingSubscribers;
+		pending.erase(std::remove(pending.begin(), pending.end(), subscriber), pending.end());
+		if (!subscribers.empty() || !pending.empty()) {
+			obs_log(LOG_DEBUG, "NDIReceiverPool::Release: '%s' still shared by %zu sources",
+				entry->key.ndi_source_name.c_str(), subscribers.size() + pending.size());
+			return;
+		}
+
+		entries.erase(entry->key);
+	}
+
+	// Last subscriber gone: no other thread can reach this entry anymore.
+	if (!Park(entry->key, entry->receiver)) {
+		obs_log(LOG_DEBUG, "NDIReceiverPool::Release: '%s' destroying shared receiver",
+			entry->key.ndi_source_name.c_str());
+		if (ndiLib) {
+			ndiLib->recv_destroy(entry->receiver);
+		}
+	}
+	delete entry;
+}
+
+NDIlib_recv_instance_t NDIReceiverPool::GetReceiver(Entry *entry)
+{
+	return entry ? entry->receiver : nullptr;
+}
+
+bool NDIReceiverPool::IsCapturer(Entry *entry, void *subscriber)
+{
+	if (!entry) {
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(entry->subscribersMutex);
+	return !entry->subscribers.empty() && entry->subscribers.front() == subscriber;
+}
+
+bool NDIReceiverPool::HasCapturer(Entry *entry)
+{
+	if (!entry) {
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(entry->subscribersMutex);
+	return !entry->subscribers.empty();
+}
+
+void NDIReceiverPool::ForEachSubscriber(Entry *entry, const SubscriberCallback &callback)
+{
+	if (!entry) {
+		return;
+	}
+
+	// Holding the lock guarantees that no subscriber is released (and freed) while it is being fed.
+	std::lock_guard<std::mutex> lock(entry->subscribersMutex);
+	for (auto subscriber : entry->subscribers) {
+		callback(subscriber);
+	}
+}
+
+void NDIReceiverPool::StartParking()
+{
+	std::lock_guard<std::mutex> lock(parkedMutex);
+	parking = true;
+}
+
+void NDIReceiverPool::StopParking()
+{
+	std::lock_guard<std::mutex> lock(parkedMutex);
+	parking = false;
+}
+
+bool NDIReceiverPool::Park(const NDIReceiverKey &key, NDIlib_recv_instance_t receiver)
+{
+	if (!receiver || !ndiLib) {
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(parkedMutex);
+	if (!parking) {
+		return false;
+	}
+
+	// A parked receiver is off air: turn its tally off as destroying it would.
+	NDIlib_tally_t tally = {false, false};
+	ndiLib->recv_set_tally(receiver, &tally);
+
+	parked.emplace(key, receiver);
+	obs_log(LOG_DEBUG, "NDIReceiverPool::Park: '%s' (bw=%d, color_format=%d) parked, %zu parked receivers",
+		key.ndi_source_name.c_str(), key.bandwidth, key.color_format, parked.size());
+	return true;
+}
+
+NDIlib_recv_instance_t NDIReceiverPool::Unpark(const NDIReceiverKey &key)
+{
+	NDIlib_recv_instance_t receiver = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(parkedMutex);
+		auto it = parked.find(key);
+		if (it == parked.end()) {
+			return nullptr;
+		}
+		receiver = it->second;
+		parked.erase(it);
+	}
+
+	// Drop the frames queued while parked, they are stale.
+	NDIlib_video_frame_v2_t video_frame;
+	NDIlib_audio_frame_v3_t audio_frame;
+	NDIlib_metadata_frame_t metadata_frame;
+	NDIlib_frame_type_e frame_type;
+	do {
+		frame_type = ndiLib->recv_capture_v3(receiver, &video_frame, &audio_frame, &metadata_frame, 0);
+		if (frame_type == NDIlib_frame_type_video) {
+			ndiLib->recv_free_video_v2(receiver, &video_frame);
+		} else if (frame_type == NDIlib_frame_type_audio) {
+			ndiLib->recv_free_audio_v3(receiver, &audio_frame);
+		} else if (frame_type == NDIlib_frame_type_metadata) {
+			ndiLib->recv_free_metadata(receiver, &metadata_frame);
+		}
+	} while (frame_type != NDIlib_frame_type_none && frame_type != NDIlib_frame_type_error);
+
+	obs_log(LOG_INFO, "NDIReceiverPool::Unpark: reusing the receiver of '%s' from the previous scene collection",
+		key.ndi_source_name.c_str());
+	return receiver;
+}
+
+void NDIReceiverPool::DestroyParked(bool force)
+{
+	std::multimap<NDIReceiverKey, NDIlib_recv_instance_t> destroyed;
+	{
+		std::lock_guard<std::mutex> lock(parkedMutex);
+		if (parking && !force) {
+			return;
+		}
+		destroyed.swap(parked);
+	}
+
+	if (destroyed.empty()) {
+		return;
+	}
+
+	obs_log(LOG_DEBUG, "NDIReceiverPool::DestroyParked: destroying %zu unused parked receivers", destroyed.size());
+	if (ndiLib) {
+		for (auto &it : destroyed) {
+			ndiLib->recv_destroy(it.second);
+		}
+	}
+}
@@ -0,0 +1,97 @@
+/******************************************************************************
+	Copyright (C) 2016-2024 DistroAV <contact@distroav.org>
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#pragma once
+
+#include "plugin-main.h"
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <Processing.NDI.Lib.h>
+
+struct NDIReceiverKey {
+	std::string ndi_source_name;
+	NDIlib_recv_bandwidth_e bandwidth;
+	NDIlib_recv_color_format_e color_format;
+	bool hw_accel;
+	// Empty for shared receivers: they are named after the source that created them, but serve any source.
+	std::string ndi_receiver_name;
+
+	bool operator<(const NDIReceiverKey &other) const
+	{
+		return std::tie(ndi_source_name, bandwidth, color_format, hw_accel, ndi_receiver_name) <
+		       std::tie(other.ndi_source_name, other.bandwidth, other.color_format, other.hw_accel,
+				other.ndi_receiver_name);
+	}
+};
+
+/**
+ * Process-wide registry of NDI receivers shared between OBS sources that pull the same feed.
+ *
+ * Receivers are keyed by (NDI source name, bandwidth, color format, hardware acceleration) and
+ * reference-counted by their subscribers (an opaque pointer per OBS source).
+ * Parked receivers that are not shared are also keyed by their receiver name, so that they are only taken over
+ * by the source they were created for.
+ * The first subscriber is the "capturer": it is the only one pulling frames from the receiver and it hands
+ * every frame to all subscribers with `ForEachSubscriber`. When the capturer releases the receiver, the next
+ * subscriber in line takes over.
+ * A source switching to another receiver (make-before-break) acquires it as a pending subscriber: it is neither
+ * capturer nor fed until it commits the switch with `Activate`, while its previous receiver still feeds it.
+ *
+ * While a scene collection is being switched, receivers that are no longer used (shared or not) are parked
+ * instead of destroyed: they stay connected and the sources of the next collection take them over with `Unpark`
+ * instead of negotiating the same connections again. Receivers still parked afterwards are destroyed with
+ * `DestroyParked`.
+ */
+class NDIReceiverPool {
+public:
+	struct Entry;
+	using SubscriberCallback = std::function<void(void *subscriber)>;
+
+	static Entry *Acquire(const NDIlib_recv_create_v3_t &recv_desc, bool hw_accel, void *subscriber,
+			      bool pending = false);
+	static void Activate(Entry *entry, void *subscriber);
+	static void Release(Entry *entry, void *subscriber);
+
+	static NDIlib_recv_instance_t GetReceiver(Entry *entry);
+	static bool IsCapturer(Entry *entry, void *subscriber);
+	// True if an active subscriber is capturing (and feeding) the receiver.
+	static bool HasCapturer(Entry *entry);
+	static void ForEachSubscriber(Entry *entry, const SubscriberCallback &callback);
+
+	static void StartParking();
+	static void StopParking();
+	// Takes ownership of the receiver and returns true if parking is active.
+	static bool Park(const NDIReceiverKey &key, NDIlib_recv_instance_t receiver);
+	// Returns a parked receiver for the key, or null.
+	static NDIlib_recv_instance_t Unpark(const NDIReceiverKey &key);
+	// Destroys the parked receivers, unless parking is active (`force` destroys them regardless).
+	static void DestroyParked(bool force = false);
+
+private:
+	static std::map<NDIReceiverKey, Entry *> entries;
+	static std::mutex entriesMutex;
+
+	static std::multimap<NDIReceiverKey, NDIlib_recv_instance_t> parked;
+	static std::mutex parkedMutex;
+	static bool parking;
+};
@@ -16,7 +16,12 @@
 ******************************************************************************/
 
 #include "plugin-main.h"
+#include "ndi-audio-routing.h"
+#include "ndi-capture-clock.h"
 #include "ndi-finder.h"
+#include "ndi-receive-engine.h"
+#include "ndi-receiver-pool.h"
+#include "ndi-video-convert.h"
 
 #include <util/platform.h>
 #include <util/threading.h>
@@ -24,7 +29,12 @@
 #include <QDesktopServices>
 #include <QUrl>
 
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 #define PROP_SOURCE "ndi_source_name"
 #define PROP_BEHAVIOR "ndi_behavior"
@@ -32,21 +42,37 @@
 #define PROP_BANDWIDTH "ndi_bw_mode"
 #define PROP_SYNC "ndi_sync"
 #define PROP_FRAMESYNC "ndi_framesync"
+#define PROP_FRAMESYNC_GENLOCK "ndi_framesync_genlock"
 #define PROP_HW_ACCEL "ndi_recv_hw_accel"
+#define PROP_SHARED_RECEIVER "ndi_shared_receiver"
+#define PROP_HIDDEN_STANDBY "ndi_hidden_standby"
+#define PROP_AUDIO_THREAD "ndi_audio_thread"
+#define PROP_AUDIO_ROUTING "ndi_audio_routing"
+#define PROP_AUDIO_ROUTING_MAP "ndi_audio_routing_map"
 #define PROP_FIX_ALPHA "ndi_fix_alpha_blending"
+#define PROP_UNPREMULTIPLY "ndi_unpremultiply_alpha"
 #define PROP_YUV_RANGE "yuv_range"
 #define PROP_YUV_COLORSPACE "yuv_colorspace"
 #define PROP_LATENCY "latency"
+#define PROP_RECV_FORMAT "ndi_recv_color_format"
 #define PROP_AUDIO "ndi_audio"
 #define PROP_PTZ "ndi_ptz"
 #define PROP_PAN "ndi_pan"
 #define PROP_TILT "ndi_tilt"
 #define PROP_ZOOM "ndi_zoom"
+#define PROP_DOWNSCALE "ndi_downscale"
+#define PROP_MAX_FPS "ndi_max_fps"
+#define PROP_CROP "ndi_crop"
+#define PROP_CROP_LEFT "ndi_crop_left"
+#define PROP_CROP_TOP "ndi_crop_top"
+#define PROP_CROP_RIGHT "ndi_crop_right"
+#define PROP_CROP_BOTTOM "ndi_crop_bottom"
 
 #define PROP_BW_UNDEFINED -1
 #define PROP_BW_HIGHEST 0
 #define PROP_BW_LOWEST 1
 #define PROP_BW_AUDIO_ONLY 2
+#define PROP_BW_AUTO 3
 
 #define PROP_BEHAVIOR_KEEP_ACTIVE 0
 #define PROP_BEHAVIOR_STOP_RESUME_BLANK 1
@@ -59,6 +85,7 @@
 #define PROP_SYNC_INTERNAL 0
 #define PROP_SYNC_NDI_TIMESTAMP 1
 #define PROP_SYNC_NDI_SOURCE_TIMECODE 2
+#define PROP_SYNC_NDI_CLOCK_RECOVERY 3
 
 #define PROP_YUV_RANGE_PARTIAL 1
 #define PROP_YUV_RANGE_FULL 2
@@ -66,11 +93,59 @@
 #define PROP_YUV_SPACE_BT601 1
 #define PROP_YUV_SPACE_BT709 2
 #define PROP_YUV_SPACE_BT2100 3
+#define PROP_YUV_SPACE_BT2100_PQ 4
 
 #define PROP_LATENCY_UNDEFINED -1
 #define PROP_LATENCY_NORMAL 0
 #define PROP_LATENCY_LOW 1
 #define PROP_LATENCY_LOWEST 2
+#define PROP_LATENCY_ADAPTIVE 3
+
+#define PROP_RECV_FORMAT_AUTO 0
+#define PROP_RECV_FORMAT_UYVA 1
+#define PROP_RECV_FORMAT_BGRA 2
+#define PROP_RECV_FORMAT_BEST 3
+
+// Time a source must stay off program (Auto bandwidth) or hidden (standby) before its receiver is downgraded.
+#define BW_DOWNGRADE_HOLD_NS 2000000000ULL
+
+// Adaptive latency: transit time window (video frames), and bounds.
+#define JITTER_WINDOW_SIZE 256
+#define JITTER_ESTIMATE_INTERVAL 16
+#define JITTER_BUFFER_MARGIN_NS 1000000LL
+#define JITTER_BUFFER_MAX_DELAY_NS 250000000LL
+#define JITTER_DISCONTINUITY_NS 1000000000LL
+
+// Adaptive latency presentation buffer capacity (frames). Audio and video frames share it: it holds the maximum
+// delay (250 ms) of 120p video with audio delivered in up to three frames per video frame, 250 ms x 480 frames/s.
+// A full buffer releases its oldest frame early.
+#define JITTER_BUFFER_CAPACITY 128
+
+// FrameSync audio pulls: a pause longer than this restarts the pull clock; the queue depth error is corrected
+// over this many pulls, by at most this fraction of a pull.
+#define FRAMESYNC_AUDIO_MAX_PULL_NS 100000000ULL
+#define FRAMESYNC_AUDIO_DEPTH_STEERING 16.0
+#define FRAMESYNC_AUDIO_MAX_CORRECTION 0.05
+
+// Clock recovery loop gains (~0.1 Hz loop bandwidth at 60 updates per second), rate bounds and re-lock threshold.
+#define CLOCK_RECOVERY_KP 0.015
+#define CLOCK_RECOVERY_KI 0.00011
+#define CLOCK_RECOVERY_MAX_RATE_DEVIATION 0.001
+#define CLOCK_RECOVERY_DISCONTINUITY_NS 200000000.0
+// Updates closer than this to the previous one only correct the phase, and audio drives the loop only after
+// video frames stopped driving it for this long.
+#define CLOCK_RECOVERY_MIN_UPDATE_NS 1000000LL
+#define CLOCK_RECOVERY_VIDEO_TIMEOUT_NS 1000000000ULL
+
+// Time after which the content of a source that receives no frames is cleared (unless it keeps its content).
+#define CONTENT_TIMEOUT_NS 3000000000ULL
+
+// Bounds of the exponential backoff between connection checks of a receiver without connection.
+#define RECONNECT_BACKOFF_MIN_NS 100000000ULL
+#define RECONNECT_BACKOFF_MAX_NS 5000000000ULL
+
+#define STATS_SAMPLE_INTERVAL_NS 1000000000ULL
+#define STATS_LOG_INTERVAL_NS 60000000000ULL
 
 typedef struct ptz_t {
 	bool enabled;
@@ -90,6 +165,9 @@ typedef struct ptz_t {
 typedef struct ndi_source_config_t {
 	bool reset_ndi_receiver = true;
 	// Initialize value to true to ensure a receiver reset on OBS launch.
+	// Resets requested by property edits are applied once no other edit came in for a short while, see
+	// `RECEIVER_RESET_DEBOUNCE_NS`.
+	uint64_t reset_ndi_receiver_ns;
 
 	//
 	// Changes that require the NDI receiver to be reset:
@@ -98,8 +176,10 @@ typedef struct ndi_source_config_t {
 	char *ndi_source_name;
 	int bandwidth;
 	int latency;
+	int recv_format;
 	bool framesync_enabled;
 	bool hw_accel_enabled;
+	bool shared_receiver_enabled;
 
 	//
 	// Changes that do NOT require the NDI receiver to be reset:
@@ -110,21 +190,233 @@ typedef struct ndi_source_config_t {
 	video_range_type yuv_range;
 	video_colorspace yuv_colorspace;
 	bool audio_enabled;
+	bool audio_thread_enabled;
+	int audio_routing;
+	bool hidden_standby_enabled;
+	bool genlock_enabled;
+	bool unpremultiply_enabled;
+	// Region of interest, in pixels removed from each side (0 = no crop).
+	int crop_left;
+	int crop_top;
+	int crop_right;
+	int crop_bottom;
+	// Output resolution divider: 1 (native), 2 or 4.
+	int downscale;
+	// Video frames above this rate are dropped on receive (0 = no limit).
+	int max_fps;
 	ptz_t ptz;
 	NDIlib_tally_t tally;
 } ndi_source_config_t;
 
+// Time a pending receiver is given to deliver its first frame before it replaces the current one anyway.
+#define RECEIVER_SWITCH_TIMEOUT_NS 3000000000ULL
+
+// Quiet time after the last property edit before the receiver is reset, so that a burst of edits (typing an NDI
+// source name, changing several settings in a row) results in a single reset.
+#define RECEIVER_RESET_DEBOUNCE_NS 300000000ULL
+
+//
+// An NDI receiver (own or shared) with its optional FrameSync, and the settings it was created with.
+//
+typedef struct ndi_receiver_instance_t {
+	NDIlib_recv_instance_t receiver;
+	NDIReceiverPool::Entry *shared_receiver;
+	NDIlib_framesync_instance_t frame_sync;
+
+	char *recv_name;
+	char *source_name;
+	NDIlib_recv_bandwidth_e bandwidth;
+	NDIlib_recv_color_format_e color_format;
+	bool hw_accel;
+} ndi_receiver_instance_t;
+
+//
+// Presentation buffer of the Adaptive latency mode.
+// Frames are held until `sender timestamp + minimum transit time + target delay`, where the target delay is the
+// 99th percentile of the transit time variation (arrival time minus sender timestamp) over the last video
+// frames. The sliding minimum also absorbs the drift between the sender clock and the local clock.
+//
+typedef struct ndi_source_buffered_frame_t {
+	NDIlib_frame_type_e type;
+	NDIlib_video_frame_v2_t video;
+	NDIlib_audio_frame_v3_t audio;
+	uint64_t release_ns;
+} ndi_source_buffered_frame_t;
+
+typedef struct ndi_source_jitter_buffer_t {
+	ndi_source_buffered_frame_t frames[JITTER_BUFFER_CAPACITY];
+	int head;
+	int count;
+
+	int64_t transit_ns[JITTER_WINDOW_SIZE];
+	int transit_count;
+	int transit_next;
+	int samples_since_estimate;
+	bool estimated;
+	int64_t transit_min_ns;
+	int64_t target_delay_ns;
+} ndi_source_jitter_buffer_t;
+
+//
+// State of the NDI receive loop, owned by whichever thread runs `ndi_source_receive_step`
+// (the dedicated source thread or a receive engine worker).
+//
+typedef struct ndi_source_receiver_t {
+	NDIlib_recv_create_v3_t recv_desc;
+
+	// Receiver feeding the source, and the receiver about to replace it once it delivers its first frame.
+	ndi_receiver_instance_t current;
+	ndi_receiver_instance_t pending;
+	uint64_t pending_deadline_ns;
+
+	int64_t timestamp_audio;
+	int64_t timestamp_video;
+
+	uint64_t framesync_interval_ns;
+	uint64_t framesync_next_capture_ns;
+	// Time of the last FrameSync audio pull and the fraction of a sample it left over.
+	uint64_t framesync_audio_pull_ns;
+	double framesync_audio_pull_remainder;
+
+	// FrameSync captured on the shared capture clock (NDICaptureClock), null when not genlocked.
+	// While set, the FrameSync capture state above and below belongs to the capture clock thread.
+	NDIlib_framesync_instance_t genlock_frame_sync;
+	NDIlib_audio_frame_v3_t framesync_audio_frame;
+	NDIlib_video_frame_v2_t framesync_video_frame;
+
+	// Polling interval of zero-timeout captures, derived from the incoming frame rate.
+	uint64_t poll_interval_ns;
+
+	ndi_source_jitter_buffer_t jitter_buffer;
+
+	uint64_t stats_next_sample_ns;
+	uint64_t stats_next_log_ns;
+
+	// Time the receiver was found without connection (0 while connected) and delay until the next check.
+	uint64_t disconnected_ns;
+	uint64_t reconnect_backoff_ns;
+	// Set by the NDI finder while the disconnected NDI source is announced on the network.
+	volatile bool sender_announced;
+
+	// Bandwidth requested from the receiver, see `ndi_source_target_bandwidth`.
+	NDIlib_recv_bandwidth_e bandwidth;
+	uint64_t bandwidth_downgrade_ns;
+
+	ptz_t ptz;
+	NDIlib_tally_t tally;
+} ndi_source_receiver_t;
+
+//
+// Receive statistics of the source.
+// Frame counters and queue depths are sampled from the NDI receiver about once per second;
+// jitter and format are updated for every video frame handed to the source.
+//
+typedef struct ndi_source_stats_t {
+	int64_t video_frames_received;
+	int64_t video_frames_dropped;
+	int64_t audio_frames_received;
+	int64_t audio_frames_dropped;
+	// Stale video frames skipped by the source itself in Lowest latency mode.
+	int64_t video_frames_discarded;
+	int video_queue_depth;
+	int audio_queue_depth;
+
+	// Smoothed variation of the interval between consecutive video frames (RFC 3550 style).
+	double video_jitter_ns;
+	uint64_t last_video_arrival_ns;
+	uint64_t last_video_interval_ns;
+
+	int width;
+	int height;
+	NDIlib_FourCC_video_type_e fourcc;
+
+	// Delay of the Adaptive latency presentation buffer.
+	int64_t jitter_buffer_delay_ns;
+
+	// Time the receiver lost its connection, 0 while connected.
+	uint64_t disconnected_since_ns;
+} ndi_source_stats_t;
+
+//
+// Clock recovery (PROP_SYNC_NDI_CLOCK_RECOVERY): maps the sender clock (NDI timestamps) to the local clock
+// (os_gettime_ns) with a second order phase-locked loop. The loop follows the drift between both clocks while
+// averaging out the network and decoding jitter of the arrival times. A jump of the sender clock (e.g. the
+// sender restarted) re-locks it at once.
+// Only one stream drives the loop: video, or audio for audio-only senders. The frames of the other stream are
+// mapped through the current estimate, since their arrival times relative to the driving stream are mostly jitter.
+//
+typedef struct ndi_clock_recovery_t {
+	bool locked;
+	int64_t base_sender_ns;
+	double base_local_ns;
+	// Local clock duration per sender clock duration.
+	double rate;
+	// Local time of the last update driven by a video frame.
+	uint64_t video_update_ns;
+} ndi_clock_recovery_t;
+
 typedef struct ndi_source_t {
 	obs_source_t *obs_source;
 	ndi_source_config_t config;
 
+	// Guards `running` and `warm`: the receive loop is started and stopped from the video thread (shown, hidden,
+	// activated) as well as from the UI thread (update, pre-connect, stop all).
+	pthread_mutex_t thread_mutex;
 	bool running;
+	// Receiver pre-connected while the source is not showing, because it is in a likely next scene (see
+	// `ndi_source_preconnect_scenes`). Cleared once the source is shown or its receiver stops.
+	bool warm;
+	// Signaled to stop the receive loop; also interrupts the waits of the audio thread.
+	os_event_t *stop_event;
+	// Cuts short the wait of the receive thread between two iterations, see `ndi_source_wake`.
+	os_event_t *wake_event;
+	bool uses_receive_engine;
 	pthread_t av_thread;
 
+	// Optional audio capture thread, started and stopped by the receive loop (see `ndi_source_audio_thread`).
+	// `audio_thread_running` is only accessed by the receive loop, which stops the thread with `audio_stop_event`.
+	bool audio_thread_running;
+	pthread_t audio_thread;
+	os_event_t *audio_stop_event;
+	ndi_source_receiver_t receiver;
+
+	// Per-source output frames; also filled by the capturer of a shared receiver.
+	obs_source_frame obs_video_frame;
+	obs_source_audio obs_audio_frame;
+
+	// Written by the receive loop, read by the "get_receive_stats" proc handler.
+	pthread_mutex_t stats_mutex;
+	ndi_source_stats_t stats;
+
+	// Fed by video and audio frames, possibly from different threads.
+	pthread_mutex_t clock_mutex;
+	ndi_clock_recovery_t clock;
+
+	// Configured by update, used by the thread capturing audio.
+	pthread_mutex_t audio_routing_mutex;
+	ndi_audio_routing_t *audio_routing;
+
+	// Color settings staged by the receive loop on receiver reset, applied to `obs_video_frame` by the thread
+	// outputting it (see `ndi_source_video_color`).
+	pthread_mutex_t video_color_mutex;
+	video_colorspace video_color_space;
+	video_range_type video_color_range;
+	bool video_color_changed;
+	// Format the color parameters of `obs_video_frame` were computed for: they depend on its bit depth.
+	video_format video_color_format;
+
 	uint32_t width;
 	uint32_t height;
 
+	// Frames converted before being output to OBS (see `ndi_source_thread_process_video2`).
+	uint8_t *video_buffer;
+	size_t video_buffer_size;
+	uint8_t *scaled_buffer;
+	size_t scaled_buffer_size;
+
 	uint64_t last_frame_timestamp;
+	// Output time slot of the next video frame when the output frame rate is limited.
+	uint64_t next_video_output_ns;
 } ndi_source_t;
 
 static obs_source_t *find_filter_by_id(obs_source_t *context, const char *id)
@@ -189,12 +481,26 @@ static video_colorspace prop_to_colorspace(int index)
 		return VIDEO_CS_601;
 	case PROP_YUV_SPACE_BT2100:
 		return VIDEO_CS_2100_HLG;
+	case PROP_YUV_SPACE_BT2100_PQ:
+		return VIDEO_CS_2100_PQ;
 	default:
 	case PROP_YUV_SPACE_BT709:
 		return VIDEO_CS_709;
 	}
 }
 
+static video_trc colorspace_to_trc(video_colorspace colorspace)
+{
+	switch (colorspace) {
+	case VIDEO_CS_2100_PQ:
+		return VIDEO_TRC_PQ;
+	case VIDEO_CS_2100_HLG:
+		return VIDEO_TRC_HLG;
+	default:
+		return VIDEO_TRC_DEFAULT;
+	}
+}
+
 static video_range_type prop_to_range_type(int index)
 {
 	switch (index) {
@@ -259,6 +565,7 @@ obs_properties_t *ndi_source_getproperties(void *data)
 	obs_property_list_add_int(bw_modes, obs_module_text("NDIPlugin.BWMode.Highest"), PROP_BW_HIGHEST);
 	obs_property_list_add_int(bw_modes, obs_module_text("NDIPlugin.BWMode.Lowest"), PROP_BW_LOWEST);
 	obs_property_list_add_int(bw_modes, obs_module_text("NDIPlugin.BWMode.AudioOnly"), PROP_BW_AUDIO_ONLY);
+	obs_property_list_add_int(bw_modes, obs_module_text("NDIPlugin.BWMode.Auto"), PROP_BW_AUTO);
 	obs_property_set_modified_callback(bw_modes, [](obs_properties_t *props_, obs_property_t *,
 							obs_data_t *settings_) {
 		bool is_audio_only = (obs_data_get_int(settings_, PROP_BANDWIDTH) == PROP_BW_AUDIO_ONLY);
@@ -279,13 +586,23 @@ obs_properties_t *ndi_source_getproperties(void *data)
 				  PROP_SYNC_NDI_TIMESTAMP);
 	obs_property_list_add_int(sync_modes, obs_module_text("NDIPlugin.SyncMode.NDISourceTimecode"),
 				  PROP_SYNC_NDI_SOURCE_TIMECODE);
+	obs_property_list_add_int(sync_modes, obs_module_text("NDIPlugin.SyncMode.ClockRecovery"),
+				  PROP_SYNC_NDI_CLOCK_RECOVERY);
 
 	obs_properties_add_bool(props, PROP_FRAMESYNC, obs_module_text("NDIPlugin.NDIFrameSync"));
 
+	obs_properties_add_bool(props, PROP_FRAMESYNC_GENLOCK, obs_module_text("NDIPlugin.NDIFrameSync.Genlock"));
+
 	obs_properties_add_bool(props, PROP_HW_ACCEL, obs_module_text("NDIPlugin.SourceProps.HWAccel"));
 
+	obs_properties_add_bool(props, PROP_SHARED_RECEIVER, obs_module_text("NDIPlugin.SourceProps.SharedReceiver"));
+
+	obs_properties_add_bool(props, PROP_HIDDEN_STANDBY, obs_module_text("NDIPlugin.SourceProps.HiddenStandby"));
+
 	obs_properties_add_bool(props, PROP_FIX_ALPHA, obs_module_text("NDIPlugin.SourceProps.AlphaBlendingFix"));
 
+	obs_properties_add_bool(props, PROP_UNPREMULTIPLY, obs_module_text("NDIPlugin.SourceProps.Unpremultiply"));
+
 	obs_property_t *yuv_ranges = obs_properties_add_list(props, PROP_YUV_RANGE,
 							     obs_module_text("NDIPlugin.SourceProps.ColorRange"),
 							     OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_INT);
@@ -299,7 +616,8 @@ obs_properties_t *ndi_source_getproperties(void *data)
 							     OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_INT);
 	obs_property_list_add_int(yuv_spaces, "BT.709", PROP_YUV_SPACE_BT709);
 	obs_property_list_add_int(yuv_spaces, "BT.601", PROP_YUV_SPACE_BT601);
-	obs_property_list_add_int(yuv_spaces, "BT.2100", PROP_YUV_SPACE_BT2100);
+	obs_property_list_add_int(yuv_spaces, "BT.2100 (HLG)", PROP_YUV_SPACE_BT2100);
+	obs_property_list_add_int(yuv_spaces, "BT.2100 (PQ)", PROP_YUV_SPACE_BT2100_PQ);
 
 	obs_property_t *latency_modes = obs_properties_add_list(props, PROP_LATENCY,
 								obs_module_text("NDIPlugin.SourceProps.Latency"),
@@ -310,9 +628,41 @@ obs_properties_t *ndi_source_getproperties(void *data)
 				  PROP_LATENCY_LOW);
 	obs_property_list_add_int(latency_modes, obs_module_text("NDIPlugin.SourceProps.Latency.Lowest"),
 				  PROP_LATENCY_LOWEST);
+	obs_property_list_add_int(latency_modes, obs_module_text("NDIPlugin.SourceProps.Latency.Adaptive"),
+				  PROP_LATENCY_ADAPTIVE);
+
+	obs_property_t *recv_formats = obs_properties_add_list(props, PROP_RECV_FORMAT,
+							       obs_module_text("NDIPlugin.SourceProps.RecvFormat"),
+							       OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_INT);
+	obs_property_list_add_int(recv_formats, obs_module_text("NDIPlugin.RecvFormat.Auto"), PROP_RECV_FORMAT_AUTO);
+	obs_property_list_add_int(recv_formats, obs_module_text("NDIPlugin.RecvFormat.UYVA"), PROP_RECV_FORMAT_UYVA);
+	obs_property_list_add_int(recv_formats, obs_module_text("NDIPlugin.RecvFormat.BGRA"), PROP_RECV_FORMAT_BGRA);
+	obs_property_list_add_int(recv_formats, obs_module_text("NDIPlugin.RecvFormat.Best"), PROP_RECV_FORMAT_BEST);
 
 	obs_properties_add_bool(props, PROP_AUDIO, obs_module_text("NDIPlugin.SourceProps.Audio"));
 
+	obs_properties_add_bool(props, PROP_AUDIO_THREAD, obs_module_text("NDIPlugin.SourceProps.AudioThread"));
+
+	obs_property_t *audio_routing = obs_properties_add_list(props, PROP_AUDIO_ROUTING,
+								obs_module_text("NDIPlugin.SourceProps.AudioRouting"),
+								OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_INT);
+	obs_property_list_add_int(audio_routing, obs_module_text("NDIPlugin.AudioRouting.FirstChannels"),
+				  NDI_AUDIO_ROUTING_FIRST_CHANNELS);
+	obs_property_list_add_int(audio_routing, obs_module_text("NDIPlugin.AudioRouting.Downmix"),
+				  NDI_AUDIO_ROUTING_DOWNMIX);
+	obs_property_list_add_int(audio_routing, obs_module_text("NDIPlugin.AudioRouting.Map"), NDI_AUDIO_ROUTING_MAP);
+	obs_property_set_modified_callback(audio_routing, [](obs_properties_t *props_, obs_property_t *,
+							     obs_data_t *settings_) {
+		bool is_map = (obs_data_get_int(settings_, PROP_AUDIO_ROUTING) == NDI_AUDIO_ROUTING_MAP);
+		obs_property_set_visible(obs_properties_get(props_, PROP_AUDIO_ROUTING_MAP), is_map);
+		return true;
+	});
+	auto audio_routing_map = obs_properties_add_text(props, PROP_AUDIO_ROUTING_MAP,
+							 obs_module_text("NDIPlugin.SourceProps.AudioRoutingMap"),
+							 OBS_TEXT_DEFAULT);
+	obs_property_set_long_description(audio_routing_map,
+					  obs_module_text("NDIPlugin.SourceProps.AudioRoutingMap.ToolTip"));
+
 	obs_properties_t *group_ptz = obs_properties_create();
 	obs_properties_add_float_slider(group_ptz, PROP_PAN, obs_module_text("NDIPlugin.SourceProps.Pan"), -1.0, 1.0,
 					0.001);
@@ -323,6 +673,29 @@ obs_properties_t *ndi_source_getproperties(void *data)
 	obs_properties_add_group(props, PROP_PTZ, obs_module_text("NDIPlugin.SourceProps.PTZ"), OBS_GROUP_CHECKABLE,
 				 group_ptz);
 
+	obs_property_t *downscale = obs_properties_add_list(props, PROP_DOWNSCALE,
+							    obs_module_text("NDIPlugin.SourceProps.Downscale"),
+							    OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_INT);
+	obs_property_list_add_int(downscale, obs_module_text("NDIPlugin.Downscale.Native"), 1);
+	obs_property_list_add_int(downscale, obs_module_text("NDIPlugin.Downscale.Half"), 2);
+	obs_property_list_add_int(downscale, obs_module_text("NDIPlugin.Downscale.Quarter"), 4);
+
+	auto max_fps = obs_properties_add_int(props, PROP_MAX_FPS, obs_module_text("NDIPlugin.SourceProps.MaxFps"), 0,
+					      240, 1);
+	obs_property_int_set_suffix(max_fps, " fps");
+
+	obs_properties_t *group_crop = obs_properties_create();
+	obs_properties_add_int(group_crop, PROP_CROP_LEFT, obs_module_text("NDIPlugin.SourceProps.CropLeft"), 0,
+			       16384, 2);
+	obs_properties_add_int(group_crop, PROP_CROP_TOP, obs_module_text("NDIPlugin.SourceProps.CropTop"), 0,
+			       16384, 2);
+	obs_properties_add_int(group_crop, PROP_CROP_RIGHT, obs_module_text("NDIPlugin.SourceProps.CropRight"), 0,
+			       16384, 2);
+	obs_properties_add_int(group_crop, PROP_CROP_BOTTOM, obs_module_text("NDIPlugin.SourceProps.CropBottom"), 0,
+			       16384, 2);
+	obs_properties_add_group(props, PROP_CROP, obs_module_text("NDIPlugin.SourceProps.Crop"), OBS_GROUP_CHECKABLE,
+				 group_crop);
+
 	obs_log(LOG_DEBUG, "-ndi_source_getproperties(…)");
 
 	return props;
@@ -338,7 +711,11 @@ void ndi_source_getdefaults(obs_data_t *settings)
 	obs_data_set_default_int(settings, PROP_YUV_RANGE, PROP_YUV_RANGE_PARTIAL);
 	obs_data_set_default_int(settings, PROP_YUV_COLORSPACE, PROP_YUV_SPACE_BT709);
 	obs_data_set_default_int(settings, PROP_LATENCY, PROP_LATENCY_NORMAL);
+	obs_data_set_default_int(settings, PROP_RECV_FORMAT, PROP_RECV_FORMAT_AUTO);
+	obs_data_set_default_int(settings, PROP_DOWNSCALE, 1);
 	obs_data_set_default_bool(settings, PROP_AUDIO, true);
+	obs_data_set_default_int(settings, PROP_AUDIO_ROUTING, NDI_AUDIO_ROUTING_FIRST_CHANNELS);
+	obs_data_set_default_string(settings, PROP_AUDIO_ROUTING_MAP, "1,2");
 	obs_log(LOG_DEBUG, "-ndi_source_getdefaults(…)");
 }
 
@@ -365,405 +742,1456 @@ void process_empty_frame(ndi_source_t *source)
 
 	uint64_t now = os_gettime_ns();
 
-	// 3 second timeout on no new data received for the source
-	uint64_t source_timeout = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::seconds(3)).count();
-
-	uint64_t target_timestamp = source->last_frame_timestamp + source_timeout;
+	uint64_t target_timestamp = source->last_frame_timestamp + CONTENT_TIMEOUT_NS;
 
 	if (now > target_timestamp) {
 		deactivate_source_output_video_texture(source);
 	}
 }
 
-void ndi_source_thread_process_audio3(ndi_source_config_t *config, NDIlib_audio_frame_v3_t *ndi_audio_frame,
+uint64_t get_obs_video_frame_interval_ns()
+{
+	// The FrameSync capture is paced on the OBS canvas frame rate.
+	// Fall back to 30 fps if the video subsystem is not (yet) initialized.
+	obs_video_info ovi;
+	if (obs_get_video_info(&ovi) && ovi.fps_num > 0 && ovi.fps_den > 0) {
+		return (uint64_t)ovi.fps_den * 1000000000ULL / (uint64_t)ovi.fps_num;
+	}
+	return 1000000000ULL / 30;
+}
+
+void ndi_source_stats_sample(ndi_source_t *s, NDIlib_recv_instance_t ndi_receiver)
+{
+	NDIlib_recv_performance_t total = {};
+	NDIlib_recv_performance_t dropped = {};
+	NDIlib_recv_queue_t queue = {};
+	ndiLib->recv_get_performance(ndi_receiver, &total, &dropped);
+	ndiLib->recv_get_queue(ndi_receiver, &queue);
+
+	pthread_mutex_lock(&s->stats_mutex);
+	s->stats.video_frames_received = total.video_frames;
+	s->stats.video_frames_dropped = dropped.video_frames;
+	s->stats.audio_frames_received = total.audio_frames;
+	s->stats.audio_frames_dropped = dropped.audio_frames;
+	s->stats.video_queue_depth = queue.video_frames;
+	s->stats.audio_queue_depth = queue.audio_frames;
+	s->stats.jitter_buffer_delay_ns = s->config.latency == PROP_LATENCY_ADAPTIVE
+						  ? s->receiver.jitter_buffer.target_delay_ns
+						  : 0;
+	pthread_mutex_unlock(&s->stats_mutex);
+}
+
+void ndi_source_stats_video_frame(ndi_source_t *s, NDIlib_video_frame_v2_t *ndi_video_frame)
+{
+	// FrameSync hands out frames on the capture schedule, not when they arrive:
+	// measure the interval on the NDI timestamps instead.
+	uint64_t arrival_ns = os_gettime_ns();
+	if (s->receiver.current.frame_sync && ndi_video_frame->timestamp != NDIlib_recv_timestamp_undefined)
+		arrival_ns = (uint64_t)(ndi_video_frame->timestamp * 100);
+
+	pthread_mutex_lock(&s->stats_mutex);
+	auto &stats = s->stats;
+	if (stats.last_video_arrival_ns && arrival_ns > stats.last_video_arrival_ns) {
+		const uint64_t interval_ns = arrival_ns - stats.last_video_arrival_ns;
+		if (stats.last_video_interval_ns) {
+			const double delta_ns = fabs((double)interval_ns - (double)stats.last_video_interval_ns);
+			stats.video_jitter_ns += (delta_ns - stats.video_jitter_ns) / 16.0;
+		}
+		stats.last_video_interval_ns = interval_ns;
+	}
+	stats.last_video_arrival_ns = arrival_ns;
+	stats.width = ndi_video_frame->xres;
+	stats.height = ndi_video_frame->yres;
+	stats.fourcc = ndi_video_frame->FourCC;
+	pthread_mutex_unlock(&s->stats_mutex);
+}
+
+void ndi_source_stats_add_discarded(ndi_source_t *s, int discarded_frames)
+{
+	pthread_mutex_lock(&s->stats_mutex);
+	s->stats.video_frames_discarded += discarded_frames;
+	pthread_mutex_unlock(&s->stats_mutex);
+}
+
+static void fourcc_to_string(NDIlib_FourCC_video_type_e fourcc, char (&str)[5])
+{
+	for (int i = 0; i < 4; ++i) {
+		const char c = (char)(((uint32_t)fourcc >> (8 * i)) & 0xff);
+		str[i] = (c >= 0x20 && c < 0x7f) ? c : '?';
+	}
+	str[4] = '\0';
+}
+
+void ndi_source_stats_log(ndi_source_t *s)
+{
+	pthread_mutex_lock(&s->stats_mutex);
+	auto stats = s->stats;
+	pthread_mutex_unlock(&s->stats_mutex);
+
+	char fourcc[5] = "----";
+	if (stats.fourcc)
+		fourcc_to_string(stats.fourcc, fourcc);
+
+	obs_log(LOG_INFO,
+		"'%s': NDI receive stats: video=%lld (dropped %lld, discarded %lld), audio=%lld (dropped %lld), queue video=%d audio=%d, jitter=%.2f ms, buffer=%.1f ms, format=%dx%d %s",
+		obs_source_get_name(s->obs_source), //
+		(long long)stats.video_frames_received, (long long)stats.video_frames_dropped,
+		(long long)stats.video_frames_discarded,
+		(long long)stats.audio_frames_received, (long long)stats.audio_frames_dropped, stats.video_queue_depth,
+		stats.audio_queue_depth, stats.video_jitter_ns / 1000000.0, stats.jitter_buffer_delay_ns / 1000000.0,
+		stats.width, stats.height, fourcc);
+}
+
+void ndi_source_get_receive_stats(void *data, calldata_t *cd)
+{
+	auto s = (ndi_source_t *)data;
+
+	pthread_mutex_lock(&s->stats_mutex);
+	auto stats = s->stats;
+	pthread_mutex_unlock(&s->stats_mutex);
+
+	char fourcc[5] = "";
+	if (stats.fourcc)
+		fourcc_to_string(stats.fourcc, fourcc);
+
+	const uint64_t disconnected_ns =
+		stats.disconnected_since_ns ? os_gettime_ns() - stats.disconnected_since_ns : 0;
+
+	calldata_set_int(cd, "video_frames_received", stats.video_frames_received);
+	calldata_set_int(cd, "video_frames_dropped", stats.video_frames_dropped);
+	calldata_set_int(cd, "video_frames_discarded", stats.video_frames_discarded);
+	calldata_set_int(cd, "audio_frames_received", stats.audio_frames_received);
+	calldata_set_int(cd, "audio_frames_dropped", stats.audio_frames_dropped);
+	calldata_set_int(cd, "video_queue_depth", stats.video_queue_depth);
+	calldata_set_int(cd, "audio_queue_depth", stats.audio_queue_depth);
+	calldata_set_float(cd, "video_jitter_ms", stats.video_jitter_ns / 1000000.0);
+	calldata_set_float(cd, "jitter_buffer_ms", stats.jitter_buffer_delay_ns / 1000000.0);
+	calldata_set_int(cd, "width", stats.width);
+	calldata_set_int(cd, "height", stats.height);
+	calldata_set_string(cd, "fourcc", fourcc);
+	calldata_set_float(cd, "disconnected_s", disconnected_ns / 1000000000.0);
+}
+
+void ndi_source_thread_process_audio3(ndi_source_t *source, NDIlib_audio_frame_v3_t *ndi_audio_frame,
 				      obs_source_t *obs_source, obs_source_audio *obs_audio_frame);
 
 void ndi_source_thread_process_video2(ndi_source_t *source, NDIlib_video_frame_v2_t *ndi_video_frame,
 				      obs_source *obs_source, obs_source_frame *obs_video_frame);
 
-void *ndi_source_thread(void *data)
+int safe_strcmp(const char *str1, const char *str2);
+
+//
+// Bandwidth the receiver should use given the source settings, its program state and its visibility:
+// - Auto bandwidth receives the highest bandwidth only while the source is on program (active), regardless of
+//   whether program tally is sent to the sender;
+// - hidden "Keep Active" sources in standby receive the lowest bandwidth, so that they stay connected at a
+//   fraction of the network and decoding cost and can be shown instantly;
+// - pre-connected sources of the likely next scene also receive the lowest bandwidth until they are shown.
+//
+NDIlib_recv_bandwidth_e ndi_source_target_bandwidth(ndi_source_t *s)
+{
+	if (s->config.bandwidth == PROP_BW_AUDIO_ONLY)
+		return NDIlib_recv_bandwidth_audio_only;
+
+	if (((s->config.hidden_standby_enabled && s->config.behavior == PROP_BEHAVIOR_KEEP_ACTIVE) || s->warm) &&
+	    !obs_source_showing(s->obs_source))
+		return NDIlib_recv_bandwidth_lowest;
+
+	switch (s->config.bandwidth) {
+	case PROP_BW_LOWEST:
+		return NDIlib_recv_bandwidth_lowest;
+	case PROP_BW_AUTO:
+		return obs_source_active(s->obs_source) ? NDIlib_recv_bandwidth_highest : NDIlib_recv_bandwidth_lowest;
+	case PROP_BW_HIGHEST:
+	default:
+		return NDIlib_recv_bandwidth_highest;
+	}
+}
+
+static const char *bandwidth_to_string(NDIlib_recv_bandwidth_e bandwidth)
+{
+	switch (bandwidth) {
+	case NDIlib_recv_bandwidth_highest:
+		return "highest";
+	case NDIlib_recv_bandwidth_lowest:
+		return "lowest";
+	case NDIlib_recv_bandwidth_audio_only:
+		return "audio only";
+	default:
+		return "metadata only";
+	}
+}
+
+void ndi_receiver_instance_destroy(ndi_source_t *s, ndi_receiver_instance_t *instance);
+void ndi_source_genlock_set(ndi_source_t *s, NDIlib_framesync_instance_t frame_sync);
+
+//
+// Creates the NDI receiver (or acquires a shared one) and its FrameSync from `recv_desc` and the source settings.
+// Returns false if they cannot be created, leaving `instance` empty.
+//
+bool ndi_receiver_instance_create(ndi_source_t *s, ndi_receiver_instance_t *instance)
 {
-	auto s = (ndi_source_t *)data;
 	auto obs_source_name = obs_source_get_name(s->obs_source);
-	obs_log(LOG_DEBUG, "'%s' +ndi_source_thread(…)", obs_source_name);
+	auto &recv_desc = s->receiver.recv_desc;
 
-	auto config = Config::Current();
-	ptz_t ptz;
-	NDIlib_tally_t tally;
+	obs_log(LOG_DEBUG,
+		"'%s' ndi_source_thread: reset_ndi_receiver: recv_desc = { p_ndi_recv_name='%s', source_to_connect_to.p_ndi_name='%s' }",
+		obs_source_name, //
+		recv_desc.p_ndi_recv_name, recv_desc.source_to_connect_to.p_ndi_name);
+	obs_log(LOG_DEBUG,
+		"'%s' ndi_source_thread: reset_ndi_receiver: +ndi_receiver = ndiLib->recv_create_v3(&recv_desc)",
+		obs_source_name);
+
+	// FrameSync instances wrap and capture from a single receiver, so they cannot be shared.
+	if (s->config.shared_receiver_enabled && !s->config.framesync_enabled) {
+		// A pending receiver must not feed the source before the switch commits, see `NDIReceiverPool`.
+		instance->shared_receiver = NDIReceiverPool::Acquire(recv_desc, s->config.hw_accel_enabled, s,
+								     instance == &s->receiver.pending);
+		instance->receiver = NDIReceiverPool::GetReceiver(instance->shared_receiver);
+	} else {
+		// A receiver parked during a scene collection switch is already connected.
+		if (recv_desc.source_to_connect_to.p_ndi_name && recv_desc.p_ndi_recv_name)
+			instance->receiver = NDIReceiverPool::Unpark(
+				{recv_desc.source_to_connect_to.p_ndi_name, recv_desc.bandwidth, recv_desc.color_format,
+				 s->config.hw_accel_enabled, recv_desc.p_ndi_recv_name});
+		if (!instance->receiver)
+			instance->receiver = ndiLib->recv_create_v3(&recv_desc);
+	}
+
+	obs_log(LOG_DEBUG,
+		"'%s' ndi_source_thread: reset_ndi_receiver: -ndi_receiver = ndiLib->recv_create_v3(&recv_desc)",
+		obs_source_name);
+	if (!instance->receiver) {
+		obs_log(LOG_ERROR, "ERR-407 - Error creating the NDI Receiver '%s' set for '%s'",
+			recv_desc.source_to_connect_to.p_ndi_name, obs_source_name);
+		obs_log(LOG_DEBUG,
+			"'%s' ndi_source_thread: reset_ndi_receiver: Cannot create ndi_receiver for NDI source '%s'",
+			obs_source_name, recv_desc.source_to_connect_to.p_ndi_name);
+		return false;
+	}
 
-	obs_source_audio obs_audio_frame = {};
-	obs_source_frame obs_video_frame = {};
+	if (s->config.hw_accel_enabled) {
+		//
+		// From https://docs.ndi.video/docs/sdk/performance-and-implementation#receiving-video :
+		// > * In the modern versions of NDI, there are internal heuristics that attempt to guess whether hardware
+		// > acceleration would enable better performance. That said, it is possible to explicitly enable hardware
+		// > acceleration if you believe that it would be beneficial for your application. This can be enabled by
+		// > sending an XML metadata message to a receiver as follows:
+		// >	<ndi_video_codec type="hardware"/>
+		//
+		// The wording of this says very unambiguously "it is possible to explicitly enable hardware acceleration",
+		// but this can in reality only ever be a **REQUEST** to enable. The enable could possibly fail for the
+		// obvious reason that the device may not have/support hardware acceleration.
+		//
+		// Furthermore, there is no documented way to request to *disable* hardware acceleration.
+		// I have tried setting the metadata to `<ndi_video_codec type=""/>` or `<ndi_video_codec/>` and it does not
+		// crash, but I was unable to confirm if this actually disabled hardware acceleration, and am skeptical that
+		// it could/would.
+		// So, it seems like there is no way to disable this.
+		// I have asked on the NewTek NDI SDK forum here:
+		// https://forum.vizrt.com/index.php?threads/any-way-to-explicitly-turn-off-hardware-acceleration.253766/
+		//
+		// Regardless, it makes little sense to have a checkbox that requests to enable this when
+		// checked but do nothing when unchecked.
+		// But that is basically what we are going to do here.
+		//
+		// One other way we try to mitigate this is to reset the NDI receiver when hw_accel_enabled is changed
+		// [in `ndi_source_update`]
+		// The theory is that the below `recv_send_metadata` is bound to the NDI receiver instance.
+		// Destroy that receiver instance and you also destroy the metadata and thus the hardware acceleration.
+		// There is no confirmation that this works as theorized.
+		//
+		NDIlib_metadata_frame_t hwAccelMetadata;
+		hwAccelMetadata.p_data = (char *)"<ndi_video_codec type=\"hardware\"/>";
+		obs_log(LOG_DEBUG,
+			"'%s' ndi_source_thread: reset_ndi_receiver; Sending NDI Hardware Acceleration metadata: '%s'",
+			obs_source_name, hwAccelMetadata.p_data);
+		ndiLib->recv_send_metadata(instance->receiver, &hwAccelMetadata);
+	}
 
-	NDIlib_recv_create_v3_t recv_desc;
-	recv_desc.allow_video_fields = true;
+	if (s->config.framesync_enabled) {
+		obs_log(LOG_DEBUG, "'%s' ndi_source_thread: +ndi_frame_sync = ndiLib->framesync_create(ndi_receiver)",
+			obs_source_name);
+		instance->frame_sync = ndiLib->framesync_create(instance->receiver);
+		obs_log(LOG_DEBUG,
+			"'%s' ndi_source_thread: -ndi_frame_sync = ndiLib->framesync_create(ndi_receiver); ndi_frame_sync=%p",
+			obs_source_name, //
+			instance->frame_sync);
+		if (!instance->frame_sync) {
+			obs_log(LOG_ERROR, "ERR-408 - Error creating the NDI Frame Sync for '%s' for '%s'",
+				recv_desc.source_to_connect_to.p_ndi_name, obs_source_name);
+			obs_log(LOG_DEBUG, "'%s' ndi_source_thread: Cannot create ndi_frame_sync for NDI source '%s'",
+				obs_source_name, recv_desc.source_to_connect_to.p_ndi_name);
+			ndi_receiver_instance_destroy(s, instance);
+			return false;
+		}
+	}
+
+	instance->recv_name = bstrdup(recv_desc.p_ndi_recv_name);
+	instance->source_name = bstrdup(recv_desc.source_to_connect_to.p_ndi_name);
+	instance->bandwidth = recv_desc.bandwidth;
+	instance->color_format = recv_desc.color_format;
+	instance->hw_accel = s->config.hw_accel_enabled;
+	return true;
+}
+
+void ndi_receiver_instance_destroy(ndi_source_t *s, ndi_receiver_instance_t *instance)
+{
+	auto obs_source_name = obs_source_get_name(s->obs_source);
+
+	if (instance->frame_sync) {
+		if (instance->frame_sync == s->receiver.genlock_frame_sync)
+			ndi_source_genlock_set(s, nullptr);
+		if (ndiLib) {
+			obs_log(LOG_DEBUG, "'%s' ndi_source_thread: ndiLib->framesync_destroy(ndi_frame_sync)",
+				obs_source_name);
+			ndiLib->framesync_destroy(instance->frame_sync);
+		}
+		instance->frame_sync = nullptr;
+	}
+
+	if (instance->shared_receiver) {
+		obs_log(LOG_DEBUG, "'%s' ndi_source_thread: NDIReceiverPool::Release(shared_receiver)",
+			obs_source_name);
+		NDIReceiverPool::Release(instance->shared_receiver, s);
+	} else if (instance->receiver) {
+		if (instance->source_name && instance->recv_name &&
+		    NDIReceiverPool::Park({instance->source_name, instance->bandwidth, instance->color_format,
+					   instance->hw_accel, instance->recv_name},
+					  instance->receiver)) {
+			obs_log(LOG_DEBUG, "'%s' ndi_source_thread: NDIReceiverPool::Park(ndi_receiver)",
+				obs_source_name);
+		} else if (ndiLib) {
+			obs_log(LOG_DEBUG, "'%s' ndi_source_thread: ndiLib->recv_destroy(ndi_receiver)",
+				obs_source_name);
+			ndiLib->recv_destroy(instance->receiver);
+		}
+	}
+
+	bfree(instance->recv_name);
+	bfree(instance->source_name);
+	*instance = {};
+}
+
+//
+// Returns true once a pending receiver has delivered its first frame.
+// Frames received while waiting on a receiver of its own are dropped: the current receiver still feeds the source.
+// A shared receiver is only inspected, never captured from.
+//
+bool ndi_receiver_instance_ready(ndi_receiver_instance_t *instance)
+{
+	if (instance->frame_sync) {
+		// FrameSync returns no video data until the receiver got its first frame.
+		NDIlib_video_frame_v2_t video_frame = {};
+		ndiLib->framesync_capture_video(instance->frame_sync, &video_frame,
+						NDIlib_frame_format_type_progressive);
+		const bool ready = video_frame.p_data != nullptr;
+		ndiLib->framesync_free_video(instance->frame_sync, &video_frame);
+		return ready;
+	}
+
+	if (instance->shared_receiver) {
+		// Another source is already capturing this shared receiver: its feed is flowing.
+		if (NDIReceiverPool::HasCapturer(instance->shared_receiver))
+			return true;
+		// Otherwise look at the queue without capturing from it: a capturer may be promoted at any time, and
+		// the frames belong to the sources it feeds.
+		NDIlib_recv_queue_t queue = {};
+		ndiLib->recv_get_queue(instance->receiver, &queue);
+		return queue.video_frames > 0 ||
+		       (instance->bandwidth == NDIlib_recv_bandwidth_audio_only && queue.audio_frames > 0);
+	}
+
+	// The receiver is not shared: drain it until it delivers a frame.
+	NDIlib_video_frame_v2_t video_frame;
+	NDIlib_audio_frame_v3_t audio_frame;
+	for (;;) {
+		switch (ndiLib->recv_capture_v3(instance->receiver, &video_frame, &audio_frame, nullptr, 0)) {
+		case NDIlib_frame_type_video:
+			ndiLib->recv_free_video_v2(instance->receiver, &video_frame);
+			return true;
+		case NDIlib_frame_type_audio:
+			ndiLib->recv_free_audio_v3(instance->receiver, &audio_frame);
+			if (instance->bandwidth == NDIlib_recv_bandwidth_audio_only)
+				return true;
+			break;
+		case NDIlib_frame_type_none:
+		case NDIlib_frame_type_error:
+			return false;
+		default:
+			break;
+		}
+	}
+}
+
+//
+// Outputs an NDI audio frame to the source, or to every showing source sharing its receiver.
+//
+void ndi_source_output_audio(ndi_source_t *s, NDIReceiverPool::Entry *shared_receiver,
+			     NDIlib_audio_frame_v3_t *audio_frame)
+{
+	if (shared_receiver) {
+		NDIReceiverPool::ForEachSubscriber(shared_receiver, [&](void *subscriber) {
+			auto sub = (ndi_source_t *)subscriber;
+			if (obs_source_showing(sub->obs_source))
+				ndi_source_thread_process_audio3(sub, audio_frame, sub->obs_source,
+								 &sub->obs_audio_frame);
+		});
+	} else {
+		ndi_source_thread_process_audio3(s, audio_frame, s->obs_source, &s->obs_audio_frame);
+	}
+}
+
+//
+// Max output fps: returns false for the video frames to drop before they are converted or copied.
+// The output slots follow the limited frame rate; a frame is accepted up to a quarter of a slot early so that
+// the arrival jitter of a faster source does not drop every other frame.
+//
+bool ndi_source_video_frame_due(ndi_source_t *s)
+{
+	const int max_fps = s->config.max_fps;
+	if (max_fps <= 0)
+		return true;
+
+	const uint64_t interval_ns = 1000000000ULL / (uint64_t)max_fps;
+	const uint64_t now = os_gettime_ns();
+	auto &next_output_ns = s->next_video_output_ns;
+	if (now + interval_ns / 4 < next_output_ns)
+		return false;
+
+	// Re-anchor the slots after a pause instead of letting a burst of frames through.
+	next_output_ns = (now > next_output_ns + interval_ns) ? now + interval_ns : next_output_ns + interval_ns;
+	return true;
+}
+
+//
+// Outputs an NDI video frame to the source, or to every showing source sharing its receiver.
+//
+void ndi_source_output_video(ndi_source_t *s, NDIReceiverPool::Entry *shared_receiver,
+			     NDIlib_video_frame_v2_t *video_frame)
+{
+	if (shared_receiver) {
+		NDIReceiverPool::ForEachSubscriber(shared_receiver, [&](void *subscriber) {
+			auto sub = (ndi_source_t *)subscriber;
+			if (obs_source_showing(sub->obs_source) && ndi_source_video_frame_due(sub))
+				ndi_source_thread_process_video2(sub, video_frame, sub->obs_source,
+								 &sub->obs_video_frame);
+		});
+	} else if (ndi_source_video_frame_due(s)) {
+		ndi_source_thread_process_video2(s, video_frame, s->obs_source, &s->obs_video_frame);
+	}
+}
+
+//
+// Clears the content of the source, or of every source sharing its receiver, once it timed out.
+// Only the capturer of a shared receiver runs it: it owns the video output of all the subscribers.
+//
+void ndi_source_process_empty_frame(ndi_source_t *s, NDIReceiverPool::Entry *shared_receiver)
+{
+	if (shared_receiver) {
+		NDIReceiverPool::ForEachSubscriber(shared_receiver, [](void *subscriber) {
+			process_empty_frame((ndi_source_t *)subscriber);
+		});
+	} else {
+		process_empty_frame(s);
+	}
+}
+
+void ndi_source_jitter_buffer_add_transit(ndi_source_jitter_buffer_t *jb, int64_t transit_ns)
+{
+	// A jump of the sender timestamps (source restarted, clock changed) invalidates the window.
+	if (jb->transit_count > 0) {
+		const int64_t last_transit_ns =
+			jb->transit_ns[(jb->transit_next + JITTER_WINDOW_SIZE - 1) % JITTER_WINDOW_SIZE];
+		if (std::abs(transit_ns - last_transit_ns) > JITTER_DISCONTINUITY_NS) {
+			jb->transit_count = 0;
+			jb->transit_next = 0;
+			jb->samples_since_estimate = 0;
+			jb->estimated = false;
+		}
+	}
+
+	jb->transit_ns[jb->transit_next] = transit_ns;
+	jb->transit_next = (jb->transit_next + 1) % JITTER_WINDOW_SIZE;
+	jb->transit_count = std::min(jb->transit_count + 1, JITTER_WINDOW_SIZE);
+	if (++jb->samples_since_estimate < JITTER_ESTIMATE_INTERVAL)
+		return;
+	jb->samples_since_estimate = 0;
+
+	int64_t offsets_ns[JITTER_WINDOW_SIZE];
+	const int64_t transit_min_ns = *std::min_element(jb->transit_ns, jb->transit_ns + jb->transit_count);
+	for (int i = 0; i < jb->transit_count; ++i) {
+		offsets_ns[i] = jb->transit_ns[i] - transit_min_ns;
+	}
+	auto p99 = offsets_ns + (jb->transit_count - 1) * 99 / 100;
+	std::nth_element(offsets_ns, p99, offsets_ns + jb->transit_count);
+
+	// Grow at once to stop stuttering, shrink slowly once the network calms down.
+	const int64_t wanted_delay_ns = std::min(*p99 + JITTER_BUFFER_MARGIN_NS, JITTER_BUFFER_MAX_DELAY_NS);
+	if (!jb->estimated || wanted_delay_ns > jb->target_delay_ns)
+		jb->target_delay_ns = wanted_delay_ns;
+	else
+		jb->target_delay_ns -= (jb->target_delay_ns - wanted_delay_ns) / 8;
+	jb->transit_min_ns = transit_min_ns;
+	jb->estimated = true;
+}
+
+void ndi_source_jitter_buffer_output(ndi_source_t *s, NDIReceiverPool::Entry *shared_receiver,
+				     ndi_source_buffered_frame_t *frame)
+{
+	auto ndi_receiver = s->receiver.current.receiver;
+	if (frame->type == NDIlib_frame_type_video) {
+		ndi_source_output_video(s, shared_receiver, &frame->video);
+		ndiLib->recv_free_video_v2(ndi_receiver, &frame->video);
+	} else {
+		ndi_source_output_audio(s, shared_receiver, &frame->audio);
+		ndiLib->recv_free_audio_v3(ndi_receiver, &frame->audio);
+	}
+}
+
+//
+// Holds a frame in the presentation buffer. Returns false if it must be output right away
+// (no sender timestamp or no transit time estimate yet).
+//
+bool ndi_source_jitter_buffer_push(ndi_source_t *s, NDIReceiverPool::Entry *shared_receiver,
+				   NDIlib_frame_type_e type, NDIlib_video_frame_v2_t *video_frame,
+				   NDIlib_audio_frame_v3_t *audio_frame)
+{
+	auto &jb = s->receiver.jitter_buffer;
+	const int64_t timestamp = type == NDIlib_frame_type_video ? video_frame->timestamp : audio_frame->timestamp;
+	if (timestamp == NDIlib_recv_timestamp_undefined)
+		return false;
+
+	const int64_t timestamp_ns = timestamp * 100;
+	if (type == NDIlib_frame_type_video)
+		ndi_source_jitter_buffer_add_transit(&jb, (int64_t)os_gettime_ns() - timestamp_ns);
+	if (!jb.estimated)
+		return false;
+
+	if (jb.count == JITTER_BUFFER_CAPACITY) {
+		ndi_source_jitter_buffer_output(s, shared_receiver, &jb.frames[jb.head]);
+		jb.head = (jb.head + 1) % JITTER_BUFFER_CAPACITY;
+		jb.count--;
+	}
+
+	auto &frame = jb.frames[(jb.head + jb.count) % JITTER_BUFFER_CAPACITY];
+	frame.type = type;
+	if (type == NDIlib_frame_type_video)
+		frame.video = *video_frame;
+	else
+		frame.audio = *audio_frame;
+	frame.release_ns = (uint64_t)std::max<int64_t>(0, timestamp_ns + jb.transit_min_ns + jb.target_delay_ns);
+	jb.count++;
+	return true;
+}
+
+//
+// Outputs the buffered frames that are due (all of them if `flush`).
+// Returns the release time of the next buffered frame, 0 if the buffer is empty.
+//
+uint64_t ndi_source_jitter_buffer_release(ndi_source_t *s, NDIReceiverPool::Entry *shared_receiver, bool flush)
+{
+	auto &jb = s->receiver.jitter_buffer;
+	const uint64_t now = os_gettime_ns();
+	while (jb.count > 0) {
+		auto &frame = jb.frames[jb.head];
+		if (!flush && frame.release_ns > now)
+			return frame.release_ns;
+		ndi_source_jitter_buffer_output(s, shared_receiver, &frame);
+		jb.head = (jb.head + 1) % JITTER_BUFFER_CAPACITY;
+		jb.count--;
+	}
+	return 0;
+}
+
+// Frees the buffered frames without outputting them, before their receiver is destroyed.
+void ndi_source_jitter_buffer_clear(ndi_source_t *s)
+{
+	auto &jb = s->receiver.jitter_buffer;
+	auto ndi_receiver = s->receiver.current.receiver;
+	for (; jb.count > 0; jb.count--) {
+		auto &frame = jb.frames[jb.head];
+		if (frame.type == NDIlib_frame_type_video)
+			ndiLib->recv_free_video_v2(ndi_receiver, &frame.video);
+		else
+			ndiLib->recv_free_audio_v3(ndi_receiver, &frame.audio);
+		jb.head = (jb.head + 1) % JITTER_BUFFER_CAPACITY;
+	}
+	jb.head = 0;
+	jb.transit_count = 0;
+	jb.transit_next = 0;
+	jb.samples_since_estimate = 0;
+	jb.estimated = false;
+}
+
+//
+// Captures and outputs the audio of the current receiver, so that audio delivery does not wait behind the
+// video frames output by the receive loop (which then captures video only).
+// The receive loop stops this thread before it replaces or destroys the current receiver.
+//
+void *ndi_source_audio_thread(void *data)
+{
+	auto s = (ndi_source_t *)data;
+	auto ndi_receiver = s->receiver.current.receiver;
+	auto shared_receiver = s->receiver.current.shared_receiver;
+	obs_log(LOG_DEBUG, "'%s' +ndi_source_audio_thread(…)", obs_source_get_name(s->obs_source));
+
+	NDIlib_audio_frame_v3_t audio_frame;
+	while (os_event_try(s->audio_stop_event) == EAGAIN && os_event_try(s->stop_event) == EAGAIN) {
+		// The sources sharing the receiver are filtered on visibility when the frame is fanned out.
+		if (!shared_receiver && !obs_source_showing(s->obs_source)) {
+			os_event_timedwait(s->audio_stop_event, 5);
+			continue;
+		}
+
+		if (ndiLib->recv_capture_v3(ndi_receiver, nullptr, &audio_frame, nullptr, 50) ==
+		    NDIlib_frame_type_audio) {
+			ndi_source_output_audio(s, shared_receiver, &audio_frame);
+			ndiLib->recv_free_audio_v3(ndi_receiver, &audio_frame);
+		}
+	}
+
+	obs_log(LOG_DEBUG, "'%s' -ndi_source_audio_thread(…)", obs_source_get_name(s->obs_source));
+	return nullptr;
+}
+
+void ndi_source_audio_thread_start(ndi_source_t *s)
+{
+	if (s->audio_thread_running)
+		return;
+	s->audio_thread_running = true;
+	os_event_reset(s->audio_stop_event);
+	pthread_create(&s->audio_thread, nullptr, ndi_source_audio_thread, s);
+}
 
-	NDIlib_recv_instance_t ndi_receiver = nullptr;
+void ndi_source_audio_thread_stop(ndi_source_t *s)
+{
+	if (!s->audio_thread_running)
+		return;
+	os_event_signal(s->audio_stop_event);
+	pthread_join(s->audio_thread, NULL);
+	s->audio_thread_running = false;
+}
+
+//
+// FrameSync capture, split in two so that the capture clock can sample all the genlocked sources before
+// outputting any of them.
+// Pulls the audio received since the previous pull and the current video frame. `interval_ns` is the expected
+// time between pulls, used for the first pull and after a pause.
+//
+void ndi_source_framesync_capture(ndi_source_t *s, NDIlib_framesync_instance_t frame_sync, uint64_t interval_ns)
+{
+	auto &receiver = s->receiver;
+
+	//
+	// Audio is pulled in the OBS format (FrameSync resamples and remaps it, so OBS does not have to), sized to
+	// the time actually elapsed since the previous pull so that the pulls follow the clock instead of the
+	// schedule. The queue depth reported by FrameSync slowly steers the pull size around one interval of
+	// buffered audio, so that FrameSync neither runs dry (inserting silence) nor overflows (dropping samples).
+	//
+	obs_audio_info oai;
+	if (!obs_get_audio_info(&oai)) {
+		oai.samples_per_sec = 48000;
+		oai.speakers = SPEAKERS_STEREO;
+	}
+
+	const uint64_t now = os_gettime_ns();
+	uint64_t elapsed_ns = now - receiver.framesync_audio_pull_ns;
+	if (receiver.framesync_audio_pull_ns == 0 || elapsed_ns > FRAMESYNC_AUDIO_MAX_PULL_NS) {
+		elapsed_ns = interval_ns;
+		receiver.framesync_audio_pull_remainder = 0.0;
+	}
+	receiver.framesync_audio_pull_ns = now;
+
+	const double elapsed_samples = (double)oai.samples_per_sec * (double)elapsed_ns / 1000000000.0 +
+				       receiver.framesync_audio_pull_remainder;
+	const double target_depth = (double)oai.samples_per_sec * (double)interval_ns / 1000000000.0;
+	const double depth_error = ndiLib->framesync_audio_queue_depth(frame_sync) - target_depth;
+	const double correction = std::clamp(depth_error / FRAMESYNC_AUDIO_DEPTH_STEERING,
+					     -elapsed_samples * FRAMESYNC_AUDIO_MAX_CORRECTION,
+					     elapsed_samples * FRAMESYNC_AUDIO_MAX_CORRECTION);
+	const int no_samples = std::max(0, (int)(elapsed_samples + correction));
+	receiver.framesync_audio_pull_remainder = elapsed_samples + correction - no_samples;
+
+	receiver.framesync_audio_frame = {};
+	if (no_samples > 0) {
+		// With a channel routing, keep all the source channels (0) for the routing matrix.
+		const int no_channels = s->config.audio_routing == NDI_AUDIO_ROUTING_FIRST_CHANNELS
+						? (int)get_audio_channels(oai.speakers)
+						: 0;
+		ndiLib->framesync_capture_audio_v2(frame_sync, &receiver.framesync_audio_frame,
+						   (int)oai.samples_per_sec, no_channels, no_samples);
+		// Note: "This function will always return data immediately, inserting silence if no current audio data is present."
+	}
+
+	// With a limited output frame rate, the video of the pulls that are not due is not even captured.
+	receiver.framesync_video_frame = {};
+	if (ndi_source_video_frame_due(s)) {
+		ndiLib->framesync_capture_video(frame_sync, &receiver.framesync_video_frame,
+						NDIlib_frame_format_type_progressive);
+	}
+}
+
+//
+// Outputs the frames pulled by `ndi_source_framesync_capture` that are new, and releases them.
+//
+void ndi_source_framesync_output(ndi_source_t *s, NDIlib_framesync_instance_t frame_sync)
+{
+	auto &receiver = s->receiver;
+	auto &audio_frame = receiver.framesync_audio_frame;
+	auto &video_frame = receiver.framesync_video_frame;
+
+	if (audio_frame.p_data && (audio_frame.timestamp > receiver.timestamp_audio)) {
+		receiver.timestamp_audio = audio_frame.timestamp;
+		ndi_source_thread_process_audio3(s, &audio_frame, s->obs_source, &s->obs_audio_frame);
+	}
+	if (audio_frame.p_data)
+		ndiLib->framesync_free_audio_v2(frame_sync, &audio_frame);
+
+	if (video_frame.p_data && (video_frame.timestamp > receiver.timestamp_video)) {
+		receiver.timestamp_video = video_frame.timestamp;
+		ndi_source_thread_process_video2(s, &video_frame, s->obs_source, &s->obs_video_frame);
+	}
+	if (video_frame.p_data)
+		ndiLib->framesync_free_video(frame_sync, &video_frame);
+}
+
+void ndi_source_genlock_capture(void *data, uint64_t interval_ns)
+{
+	auto s = (ndi_source_t *)data;
+	ndi_source_framesync_capture(s, s->receiver.genlock_frame_sync, interval_ns);
+}
+
+void ndi_source_genlock_output(void *data)
+{
+	auto s = (ndi_source_t *)data;
+	ndi_source_framesync_output(s, s->receiver.genlock_frame_sync);
+}
+
+//
+// Hands the FrameSync capture of the source over to the shared capture clock (`frame_sync` not null),
+// or takes it back (null). Taking it back waits for a tick in progress to complete.
+//
+void ndi_source_genlock_set(ndi_source_t *s, NDIlib_framesync_instance_t frame_sync)
+{
+	auto &genlock_frame_sync = s->receiver.genlock_frame_sync;
+	if (genlock_frame_sync == frame_sync)
+		return;
+
+	if (genlock_frame_sync) {
+		NDICaptureClock::Remove(s);
+		obs_log(LOG_DEBUG, "'%s' ndi_source_thread: FrameSync capture detached from the capture clock",
+			obs_source_get_name(s->obs_source));
+	}
+	genlock_frame_sync = frame_sync;
+	if (genlock_frame_sync) {
+		NDICaptureClock::Add(s, ndi_source_genlock_capture, ndi_source_genlock_output);
+		obs_log(LOG_DEBUG, "'%s' ndi_source_thread: FrameSync capture attached to the capture clock",
+			obs_source_get_name(s->obs_source));
+	}
+}
+
+//
+// Resets the capture state when a receiver starts feeding the source.
+//
+void ndi_source_receiver_activated(ndi_source_t *s)
+{
+	auto &receiver = s->receiver;
+	// The capture state is about to be reset: take it back from the capture clock first.
+	ndi_source_genlock_set(s, nullptr);
+	receiver.timestamp_audio = 0;
+	receiver.timestamp_video = 0;
+	receiver.framesync_next_capture_ns = 0;
+	receiver.framesync_audio_pull_ns = 0;
+	if (receiver.current.frame_sync) {
+		receiver.framesync_interval_ns = get_obs_video_frame_interval_ns();
+		obs_log(LOG_DEBUG, "'%s' ndi_source_thread: FrameSync capture interval=%llu ns",
+			obs_source_get_name(s->obs_source), //
+			(unsigned long long)receiver.framesync_interval_ns);
+	}
+	// The tally state is per receiver: send it again to the new one.
+	receiver.tally = {};
+	// The connection of the new receiver is tracked from scratch, possibly for another NDI source.
+	if (receiver.disconnected_ns) {
+		NDIFinder::unwatchPresence(s);
+		receiver.disconnected_ns = 0;
+	}
+}
+
+//
+// Cuts short the wait of the receive loop, so that it runs its next iteration immediately.
+//
+void ndi_source_wake(ndi_source_t *s)
+{
+	if (s->uses_receive_engine)
+		NDIReceiveEngine::Wake(s);
+	else
+		os_event_signal(s->wake_event);
+}
+
+//
+// Called by the receive loop while its receiver has no connection. Instead of polling the receiver at a fixed
+// pace, the loop checks it with an exponential backoff and the NDI finder wakes it up as soon as the NDI source
+// is announced on the network again, which resets the backoff. Returns the time of the next check.
+//
+uint64_t ndi_source_receiver_disconnected(ndi_source_t *s, uint64_t now)
+{
+	auto &receiver = s->receiver;
+	if (receiver.disconnected_ns == 0) {
+		receiver.disconnected_ns = now;
+		receiver.reconnect_backoff_ns = RECONNECT_BACKOFF_MIN_NS;
+		pthread_mutex_lock(&s->stats_mutex);
+		s->stats.disconnected_since_ns = now;
+		pthread_mutex_unlock(&s->stats_mutex);
+		os_atomic_set_bool(&receiver.sender_announced, false);
+		NDIFinder::watchPresence(s, receiver.current.source_name, [](void *param, bool online) {
+			auto source = (ndi_source_t *)param;
+			os_atomic_set_bool(&source->receiver.sender_announced, online);
+			if (online)
+				ndi_source_wake(source);
+		});
+		obs_log(LOG_DEBUG, "'%s' ndi_source_thread: No connection to '%s'; waiting for it",
+			obs_source_get_name(s->obs_source), receiver.current.source_name);
+	} else if (os_atomic_load_bool(&receiver.sender_announced)) {
+		// The NDI source is back on the network: check at the fastest pace until the receiver connects.
+		receiver.reconnect_backoff_ns = RECONNECT_BACKOFF_MIN_NS;
+	} else {
+		receiver.reconnect_backoff_ns =
+			std::min<uint64_t>(receiver.reconnect_backoff_ns * 2, RECONNECT_BACKOFF_MAX_NS);
+	}
+
+	uint64_t next_check_ns = now + receiver.reconnect_backoff_ns;
+	// Wake up in time to clear the content when it times out, see `process_empty_frame`.
+	const uint64_t content_timeout_ns = s->last_frame_timestamp + CONTENT_TIMEOUT_NS + 1000000ULL;
+	if (s->config.timeout_action != PROP_TIMEOUT_KEEP_CONTENT && s->width != 0 && content_timeout_ns > now)
+		next_check_ns = std::min(next_check_ns, content_timeout_ns);
+	return next_check_ns;
+}
+
+//
+// Called by the receive loop while its receiver has a connection.
+//
+void ndi_source_receiver_connected(ndi_source_t *s, uint64_t now)
+{
+	auto &receiver = s->receiver;
+	if (receiver.disconnected_ns == 0)
+		return;
+
+	NDIFinder::unwatchPresence(s);
+	const double disconnected_s = (double)(now - receiver.disconnected_ns) / 1000000000.0;
+	if (disconnected_s >= 1.0)
+		obs_log(LOG_INFO, "'%s': NDI source '%s' reconnected after %.1f s", obs_source_get_name(s->obs_source),
+			receiver.current.source_name, disconnected_s);
+	receiver.disconnected_ns = 0;
+
+	pthread_mutex_lock(&s->stats_mutex);
+	s->stats.disconnected_since_ns = 0;
+	pthread_mutex_unlock(&s->stats_mutex);
+}
+
+//
+// Runs one iteration of the NDI receive loop for the source.
+// `capture_timeout_ms` is the timeout used to capture from the NDI receiver (0 = do not block).
+// `next_run_ns` receives the absolute time (os_gettime_ns) at which the next iteration is due, 0 for "now".
+// Returns false when the NDI receiver cannot be created and the loop must stop.
+//
+bool ndi_source_receive_step(ndi_source_t *s, uint32_t capture_timeout_ms, uint64_t *next_run_ns)
+{
+	auto obs_source_name = obs_source_get_name(s->obs_source);
+	auto config = Config::Current(false);
+	*next_run_ns = 0;
+
+	auto &ptz = s->receiver.ptz;
+	auto &tally = s->receiver.tally;
+
+	auto &recv_desc = s->receiver.recv_desc;
+
+	auto &ndi_receiver = s->receiver.current.receiver;
+	auto &shared_receiver = s->receiver.current.shared_receiver;
 	NDIlib_video_frame_v2_t video_frame;
 
-	NDIlib_metadata_frame_t metadata_frame;
-	NDIlib_framesync_instance_t ndi_frame_sync = nullptr;
+	auto &ndi_frame_sync = s->receiver.current.frame_sync;
 	NDIlib_audio_frame_v3_t audio_frame;
 	NDIlib_frame_type_e frame_received = NDIlib_frame_type_none;
 
-	int64_t timestamp_audio = 0;
-	int64_t timestamp_video = 0;
+	auto &framesync_interval_ns = s->receiver.framesync_interval_ns;
+	auto &framesync_next_capture_ns = s->receiver.framesync_next_capture_ns;
+
+	auto &poll_interval_ns = s->receiver.poll_interval_ns;
 
 	//
-	// Main NDI receiver loop: BEGIN
+	// Bandwidth policy (Auto bandwidth, standby of hidden sources): downgrades are held for a moment so that quick
+	// cuts back and forth do not reconnect the receiver twice. Switches go through the same debounce as property
+	// edits, and a switch that is reverted before the reset leaves the receiver untouched.
 	//
-	while (s->running) {
+	const auto target_bandwidth = ndi_source_target_bandwidth(s);
+	auto &bandwidth = s->receiver.bandwidth;
+	auto &bandwidth_downgrade_ns = s->receiver.bandwidth_downgrade_ns;
+	if (target_bandwidth == bandwidth) {
+		bandwidth_downgrade_ns = 0;
+	} else {
+		const bool hold = bandwidth == NDIlib_recv_bandwidth_highest &&
+				  target_bandwidth == NDIlib_recv_bandwidth_lowest &&
+				  s->config.bandwidth != PROP_BW_LOWEST;
+		const uint64_t now = os_gettime_ns();
+		if (hold && bandwidth_downgrade_ns == 0) {
+			bandwidth_downgrade_ns = now + BW_DOWNGRADE_HOLD_NS;
+		} else if (!hold || now >= bandwidth_downgrade_ns) {
+			obs_log(LOG_INFO, "'%s': Switching receive bandwidth from %s to %s", obs_source_name,
+				bandwidth_to_string(bandwidth), bandwidth_to_string(target_bandwidth));
+			bandwidth = target_bandwidth;
+			bandwidth_downgrade_ns = 0;
+			s->config.reset_ndi_receiver_ns =
+				std::max<uint64_t>(s->config.reset_ndi_receiver_ns, now + RECEIVER_RESET_DEBOUNCE_NS);
+			s->config.reset_ndi_receiver = true;
+		}
+	}
+
+	//
+	// reset_ndi_receiver: BEGIN
+	//
+	if (s->config.reset_ndi_receiver && os_gettime_ns() >= s->config.reset_ndi_receiver_ns) {
+		s->config.reset_ndi_receiver = false;
+
+		// If config.ndi_receiver_name changed, then so did obs_source_name
+		obs_source_name = obs_source_get_name(s->obs_source);
+
 		//
-		// reset_ndi_receiver: BEGIN
+		// Update recv_desc.p_ndi_recv_name
 		//
-		if (s->config.reset_ndi_receiver) {
-			s->config.reset_ndi_receiver = false;
+		recv_desc.p_ndi_recv_name = s->config.ndi_receiver_name;
+		obs_log(LOG_DEBUG,
+			"'%s' ndi_source_thread: reset_ndi_receiver; Setting recv_desc.p_ndi_recv_name='%s'",
+			obs_source_name, //
+			recv_desc.p_ndi_recv_name);
 
-			// If config.ndi_receiver_name changed, then so did obs_source_name
-			obs_source_name = obs_source_get_name(s->obs_source);
+		//
+		// Update recv_desc.source_to_connect_to.p_ndi_name
+		//
+		recv_desc.source_to_connect_to.p_ndi_name = s->config.ndi_source_name;
+		obs_log(LOG_DEBUG,
+			"'%s' ndi_source_thread: reset_ndi_receiver; Setting recv_desc.source_to_connect_to.p_ndi_name='%s'",
+			obs_source_name, //
+			recv_desc.source_to_connect_to.p_ndi_name);
 
-			//
-			// Update recv_desc.p_ndi_recv_name
-			//
-			recv_desc.p_ndi_recv_name = s->config.ndi_receiver_name;
-			obs_log(LOG_DEBUG,
-				"'%s' ndi_source_thread: reset_ndi_receiver; Setting recv_desc.p_ndi_recv_name='%s'",
-				obs_source_name, //
-				recv_desc.p_ndi_recv_name);
+		//
+		// Update recv_desc.bandwidth
+		//
+		recv_desc.bandwidth = bandwidth;
+		obs_log(LOG_DEBUG, "'%s' ndi_source_thread: reset_ndi_receiver; Setting recv_desc.bandwidth=%d",
+			obs_source_name, //
+			recv_desc.bandwidth);
 
-			//
-			// Update recv_desc.source_to_connect_to.p_ndi_name
-			//
-			recv_desc.source_to_connect_to.p_ndi_name = s->config.ndi_source_name;
-			obs_log(LOG_DEBUG,
-				"'%s' ndi_source_thread: reset_ndi_receiver; Setting recv_desc.source_to_connect_to.p_ndi_name='%s'",
-				obs_source_name, //
-				recv_desc.source_to_connect_to.p_ndi_name);
+		//
+		// Update recv_desc.color_format: from the latency mode unless a receive format is forced.
+		// "fastest" delivers UYVA (YUV 4:2:2 + alpha) for sources with alpha, half the size of BGRA.
+		// "best" delivers 16-bit P216/PA16 for high bit depth (HDR) sources.
+		//
+		if (s->config.recv_format == PROP_RECV_FORMAT_UYVA)
+			recv_desc.color_format = NDIlib_recv_color_format_fastest;
+		else if (s->config.recv_format == PROP_RECV_FORMAT_BGRA)
+			recv_desc.color_format = NDIlib_recv_color_format_BGRX_BGRA;
+		else if (s->config.recv_format == PROP_RECV_FORMAT_BEST)
+			recv_desc.color_format = NDIlib_recv_color_format_best;
+		else if (s->config.latency == PROP_LATENCY_NORMAL)
+			recv_desc.color_format = NDIlib_recv_color_format_UYVY_BGRA;
+		else
+			recv_desc.color_format = NDIlib_recv_color_format_fastest;
+		obs_log(LOG_DEBUG,
+			"'%s' ndi_source_thread: reset_ndi_receiver; Setting recv_desc.color_format=%d",
+			obs_source_name, //
+			recv_desc.color_format);
 
-			//
-			// Update recv_desc.bandwidth
-			//
-			switch (s->config.bandwidth) {
-			case PROP_BW_HIGHEST:
-			default:
-				recv_desc.bandwidth = NDIlib_recv_bandwidth_highest;
-				break;
-			case PROP_BW_LOWEST:
-				recv_desc.bandwidth = NDIlib_recv_bandwidth_lowest;
-				break;
-			case PROP_BW_AUDIO_ONLY:
-				recv_desc.bandwidth = NDIlib_recv_bandwidth_audio_only;
-				break;
-			}
-			obs_log(LOG_DEBUG, "'%s' ndi_source_thread: reset_ndi_receiver; Setting recv_desc.bandwidth=%d",
-				obs_source_name, //
-				recv_desc.bandwidth);
+		pthread_mutex_lock(&s->video_color_mutex);
+		s->video_color_space = s->config.yuv_colorspace;
+		s->video_color_range = s->config.yuv_range;
+		s->video_color_changed = true;
+		pthread_mutex_unlock(&s->video_color_mutex);
 
-			//
-			// Update recv_desc.latency
-			//
-			if (s->config.latency == PROP_LATENCY_NORMAL)
-				recv_desc.color_format = NDIlib_recv_color_format_UYVY_BGRA;
-			else
-				recv_desc.color_format = NDIlib_recv_color_format_fastest;
+		//
+		// recv_desc is fully populated; now decide how to apply it:
+		// - nothing that matters to the receiver changed: keep it as is;
+		// - only the NDI source changed: retarget the existing receiver with recv_connect;
+		// - otherwise create a new receiver and keep the current one feeding the source until the new one
+		//   delivers its first frame (make-before-break, see below).
+		//
+		const bool shared_requested = s->config.shared_receiver_enabled && !s->config.framesync_enabled;
+		auto &current = s->receiver.current;
+		const bool same_receiver_settings =
+			current.receiver && (current.shared_receiver != nullptr) == shared_requested &&
+			(current.frame_sync != nullptr) == s->config.framesync_enabled &&
+			current.bandwidth == recv_desc.bandwidth && current.color_format == recv_desc.color_format &&
+			current.hw_accel == s->config.hw_accel_enabled &&
+			// Shared receivers are named after the source that created them, see `NDIReceiverKey`.
+			(shared_requested || safe_strcmp(current.recv_name, recv_desc.p_ndi_recv_name) == 0);
+		const bool same_ndi_source =
+			safe_strcmp(current.source_name, recv_desc.source_to_connect_to.p_ndi_name) == 0;
+
+		// A newer configuration supersedes any receiver still waiting to be swapped in.
+		ndi_receiver_instance_destroy(s, &s->receiver.pending);
+
+		if (same_receiver_settings && same_ndi_source) {
+			obs_log(LOG_DEBUG, "'%s' ndi_source_thread: reset_ndi_receiver: NDI receiver unchanged",
+				obs_source_name);
+		} else if (same_receiver_settings && !shared_requested) {
 			obs_log(LOG_DEBUG,
-				"'%s' ndi_source_thread: reset_ndi_receiver; Setting recv_desc.color_format=%d",
-				obs_source_name, //
-				recv_desc.color_format);
+				"'%s' ndi_source_thread: reset_ndi_receiver: ndiLib->recv_connect(ndi_receiver, '%s')",
+				obs_source_name, recv_desc.source_to_connect_to.p_ndi_name);
+			ndiLib->recv_connect(ndi_receiver, &recv_desc.source_to_connect_to);
+			bfree(current.source_name);
+			current.source_name = bstrdup(recv_desc.source_to_connect_to.p_ndi_name);
+			ndi_source_receiver_activated(s);
+		} else if (!ndi_receiver) {
+			if (!ndi_receiver_instance_create(s, &current))
+				return false;
+			ndi_source_receiver_activated(s);
+		} else {
+			obs_log(LOG_DEBUG,
+				"'%s' ndi_source_thread: reset_ndi_receiver: Creating pending NDI receiver for '%s'",
+				obs_source_name, recv_desc.source_to_connect_to.p_ndi_name);
+			if (!ndi_receiver_instance_create(s, &s->receiver.pending))
+				return false;
+			s->receiver.pending_deadline_ns = os_gettime_ns() + RECEIVER_SWITCH_TIMEOUT_NS;
+		}
+	}
+	//
+	// reset_ndi_receiver: END
+	//
 
-			video_format_get_parameters(s->config.yuv_colorspace, s->config.yuv_range,
-						    obs_video_frame.color_matrix, obs_video_frame.color_range_min,
-						    obs_video_frame.color_range_max);
+	//
+	// Make-before-break: swap in the pending receiver once it delivers its first frame, or after
+	// RECEIVER_SWITCH_TIMEOUT_NS if it does not (the new NDI source may be offline).
+	//
+	if (s->receiver.pending.receiver) {
+		const bool pending_ready = ndi_receiver_instance_ready(&s->receiver.pending);
+		if (pending_ready || os_gettime_ns() >= s->receiver.pending_deadline_ns) {
+			obs_log(LOG_DEBUG, "'%s' ndi_source_thread: Swapping in pending NDI receiver for '%s' (%s)",
+				obs_source_name, s->receiver.pending.source_name,
+				pending_ready ? "first frame received" : "timed out");
+			ndi_source_audio_thread_stop(s);
+			ndi_source_jitter_buffer_clear(s);
+			ndi_receiver_instance_destroy(s, &s->receiver.current);
+			s->receiver.current = s->receiver.pending;
+			s->receiver.pending = {};
+			NDIReceiverPool::Activate(s->receiver.current.shared_receiver, s);
+			ndi_source_receiver_activated(s);
+		}
+	}
 
-			//
-			// recv_desc is fully populated;
-			// now reset the NDI receiver, destroying any existing ndi_frame_sync or ndi_receiver.
-			//
-			obs_log(LOG_DEBUG, "'%s' ndi_source_thread: reset_ndi_receiver: Resetting NDI receiver…",
-				obs_source_name);
+	//
+	// Now that we have a stable usable ndi_receiver,
+	// check if there are any connections.
+	// If not then micro-pause and restart the loop.
+	//
+	if (ndiLib->recv_get_no_connections(ndi_receiver) == 0) {
+#if 0
+		obs_log(LOG_DEBUG,
+			"'%s' ndi_source_thread: No connection; sleep and restart loop",
+			obs_source_name);
+#endif
+		ndi_source_genlock_set(s, nullptr);
+		if (!shared_receiver || NDIReceiverPool::IsCapturer(shared_receiver, s))
+			ndi_source_process_empty_frame(s, shared_receiver);
+
+		const uint64_t now = os_gettime_ns();
+		uint64_t next_check_ns = ndi_source_receiver_disconnected(s, now);
+		if (s->config.reset_ndi_receiver)
+			next_check_ns = std::min(next_check_ns, std::max(now, s->config.reset_ndi_receiver_ns));
+		// Keep polling a pending receiver at a faster pace so that it is swapped in promptly.
+		*next_run_ns = s->receiver.pending.receiver ? now + 5000000ULL : next_check_ns;
+		return true;
+	}
+	ndi_source_receiver_connected(s, os_gettime_ns());
 
-			if (ndi_frame_sync) {
-				obs_log(LOG_DEBUG, "'%s' ndi_source_thread: ndiLib->framesync_destroy(ndi_frame_sync)",
-					obs_source_name);
-				ndiLib->framesync_destroy(ndi_frame_sync);
-				ndi_frame_sync = nullptr;
-			}
+	//
+	// Receive statistics: sampled from the (possibly shared) receiver, logged periodically.
+	//
+	const uint64_t stats_now_ns = os_gettime_ns();
+	if (stats_now_ns >= s->receiver.stats_next_sample_ns) {
+		s->receiver.stats_next_sample_ns = stats_now_ns + STATS_SAMPLE_INTERVAL_NS;
+		ndi_source_stats_sample(s, ndi_receiver);
+		if (s->receiver.stats_next_log_ns == 0) {
+			s->receiver.stats_next_log_ns = stats_now_ns + STATS_LOG_INTERVAL_NS;
+		} else if (stats_now_ns >= s->receiver.stats_next_log_ns) {
+			s->receiver.stats_next_log_ns = stats_now_ns + STATS_LOG_INTERVAL_NS;
+			ndi_source_stats_log(s);
+		}
+	}
 
-			if (ndi_receiver) {
+	//
+	// Change PTZ: Realtime updated from Source settings UI
+	//
+	if (s->config.ptz.enabled) {
+		const static float tollerance = 0.001f;
+		if (fabs(s->config.ptz.pan - ptz.pan) > tollerance ||
+		    fabs(s->config.ptz.tilt - ptz.tilt) > tollerance ||
+		    fabs(s->config.ptz.zoom - ptz.zoom) > tollerance) {
+			ptz = s->config.ptz;
+			if (ndiLib->recv_ptz_is_supported(ndi_receiver)) {
 				obs_log(LOG_DEBUG,
-					"'%s' ndi_source_thread: reset_ndi_receiver: ndiLib->recv_destroy(ndi_receiver)",
-					obs_source_name);
-				ndiLib->recv_destroy(ndi_receiver);
-				ndi_receiver = nullptr;
+					"'%s' ndi_source_thread: ptz changed; Sending PTZ pan=%f, tilt=%f, zoom=%f",
+					obs_source_name, //
+					ptz.pan, ptz.tilt, ptz.zoom);
+				ndiLib->recv_ptz_pan_tilt(ndi_receiver, ptz.pan, ptz.tilt);
+				ndiLib->recv_ptz_zoom(ndi_receiver, ptz.zoom);
 			}
+		}
+	}
 
-			obs_log(LOG_DEBUG,
-				"'%s' ndi_source_thread: reset_ndi_receiver: recv_desc = { p_ndi_recv_name='%s', source_to_connect_to.p_ndi_name='%s' }",
-				obs_source_name, //
-				recv_desc.p_ndi_recv_name, recv_desc.source_to_connect_to.p_ndi_name);
-			obs_log(LOG_DEBUG,
-				"'%s' ndi_source_thread: reset_ndi_receiver: +ndi_receiver = ndiLib->recv_create_v3(&recv_desc)",
-				obs_source_name);
+	//
+	// Change Tally: Enable/Disable updated from Plugin settings UI
+	//
+#if 0
+	obs_log(LOG_DEBUG, "'%s' t{pre=%d,pro=%d}",
+		obs_source_name, //
+		s->config.tally2.on_preview,
+		s->config.tally2.on_program);
+#endif
+	const bool is_capturer = !shared_receiver || NDIReceiverPool::IsCapturer(shared_receiver, s);
+	NDIlib_tally_t source_tally = s->config.tally;
+	bool source_showing = obs_source_showing(s->obs_source);
+	if (shared_receiver && is_capturer) {
+		// The receiver tally and visibility reflect every source sharing this receiver.
+		NDIReceiverPool::ForEachSubscriber(shared_receiver, [&](void *subscriber) {
+			auto sub = (ndi_source_t *)subscriber;
+			source_tally.on_preview |= sub->config.tally.on_preview;
+			source_tally.on_program |= sub->config.tally.on_program;
+			source_showing |= obs_source_showing(sub->obs_source);
+		});
+	}
+	if (is_capturer && ((config->TallyPreviewEnabled && source_tally.on_preview != tally.on_preview) ||
+			    (config->TallyProgramEnabled && source_tally.on_program != tally.on_program))) {
+		tally.on_preview = source_tally.on_preview;
+		tally.on_program = source_tally.on_program;
+		obs_log(LOG_INFO, "'%s': Tally status : on_preview=%d, on_program=%d", obs_source_name,
+			tally.on_preview, tally.on_program);
+		obs_log(LOG_DEBUG,
+			"'%s' ndi_source_thread: tally changed; Sending tally on_preview=%d, on_program=%d",
+			obs_source_name, tally.on_preview, tally.on_program);
+		ndiLib->recv_set_tally(ndi_receiver, &tally);
+	}
+
+	//
+	// Separate audio capture thread: only without FrameSync (which is pulled on the capture schedule), only
+	// for the source capturing the receiver, and not in Adaptive latency where audio is buffered with video.
+	//
+	if (s->config.audio_thread_enabled && !ndi_frame_sync && is_capturer &&
+	    s->config.latency != PROP_LATENCY_ADAPTIVE) {
+		ndi_source_audio_thread_start(s);
+	} else {
+		ndi_source_audio_thread_stop(s);
+	}
 
-			ndi_receiver = ndiLib->recv_create_v3(&recv_desc);
+	//
+	// If this source isn't showing in OBS then don't receive any frames from NDI. This occurs when multiple
+	// scenes have NDI sources that are not being shown and behavior is set to Keep Active. Without this check,
+	// the fps of OBS can decrease dramatically, especially with multiple 4K 60 sources.
+	//
+	if (!source_showing) {
+		// Frames held by the Adaptive latency buffer would be stale once the source is shown again.
+		ndi_source_jitter_buffer_clear(s);
+		ndi_source_genlock_set(s, nullptr);
 
-			obs_log(LOG_DEBUG,
-				"'%s' ndi_source_thread: reset_ndi_receiver: -ndi_receiver = ndiLib->recv_create_v3(&recv_desc)",
-				obs_source_name);
-			if (!ndi_receiver) {
-				obs_log(LOG_ERROR, "ERR-407 - Error creating the NDI Receiver '%s' set for '%s'",
-					recv_desc.source_to_connect_to.p_ndi_name, obs_source_name);
-				obs_log(LOG_DEBUG,
-					"'%s' ndi_source_thread: reset_ndi_receiver: Cannot create ndi_receiver for NDI source '%s'",
-					obs_source_name, recv_desc.source_to_connect_to.p_ndi_name);
-				break;
-			}
+		// Avoid busy-waiting when the source is hidden but kept active.
+		*next_run_ns = os_gettime_ns() + 5000000ULL;
+		return true;
+	}
 
-			if (s->config.hw_accel_enabled) {
-				//
-				// From https://docs.ndi.video/docs/sdk/performance-and-implementation#receiving-video :
-				// > * In the modern versions of NDI, there are internal heuristics that attempt to guess whether hardware
-				// > acceleration would enable better performance. That said, it is possible to explicitly enable hardware
-				// > acceleration if you believe that it would be beneficial for your application. This can be enabled by
-				// > sending an XML metadata message to a receiver as follows:
-				// >	<ndi_video_codec type="hardware"/>
-				//
-				// The wording of this says very unambiguously "it is possible to explicitly enable hardware acceleration",
-				// but this can in reality only ever be a **REQUEST** to enable. The enable could possibly fail for the
-				// obvious reason that the device may not have/support hardware acceleration.
-				//
-				// Furthermore, there is no documented way to request to *disable* hardware acceleration.
-				// I have tried setting the metadata to `<ndi_video_codec type=""/>` or `<ndi_video_codec/>` and it does not
-				// crash, but I was unable to confirm if this actually disabled hardware acceleration, and am skeptical that
-				// it could/would.
-				// So, it seems like there is no way to disable this.
-				// I have asked on the NewTek NDI SDK forum here:
-				// https://forum.vizrt.com/index.php?threads/any-way-to-explicitly-turn-off-hardware-acceleration.253766/
-				//
-				// Regardless, it makes little sense to have a checkbox that requests to enable this when
-				// checked but do nothing when unchecked.
-				// But that is basically what we are going to do here.
-				//
-				// One other way we try to mitigate this is to reset the NDI receiver when hw_accel_enabled is changed
-				// [in `ndi_source_update`]
-				// The theory is that the below `recv_send_metadata` is bound to the NDI receiver instance.
-				// Destroy that receiver instance and you also destroy the metadata and thus the hardware acceleration.
-				// There is no confirmation that this works as theorized.
-				//
-				NDIlib_metadata_frame_t hwAccelMetadata;
-				hwAccelMetadata.p_data = (char *)"<ndi_video_codec type=\"hardware\"/>";
-				obs_log(LOG_DEBUG,
-					"'%s' ndi_source_thread: reset_ndi_receiver; Sending NDI Hardware Acceleration metadata: '%s'",
-					obs_source_name, hwAccelMetadata.p_data);
-				ndiLib->recv_send_metadata(ndi_receiver, &hwAccelMetadata);
-			}
+	//
+	// Shared receiver: only the capturer pulls frames and fans them out to every subscriber.
+	// The other subscribers idle until they are promoted to capturer, their content timeout included.
+	//
+	if (!is_capturer) {
+		ndi_source_genlock_set(s, nullptr);
+		*next_run_ns = os_gettime_ns() + 100000000ULL;
+		return true;
+	}
 
-			if (s->config.framesync_enabled) {
-				timestamp_audio = 0;
-				timestamp_video = 0;
-				obs_log(LOG_DEBUG,
-					"'%s' ndi_source_thread: +ndi_frame_sync = ndiLib->framesync_create(ndi_receiver)",
-					obs_source_name);
-				ndi_frame_sync = ndiLib->framesync_create(ndi_receiver);
-				obs_log(LOG_DEBUG,
-					"'%s' ndi_source_thread: -ndi_frame_sync = ndiLib->framesync_create(ndi_receiver); ndi_frame_sync=%p",
-					obs_source_name, //
-					ndi_frame_sync);
-				if (!ndi_frame_sync) {
-					obs_log(LOG_ERROR,
-						"ERR-408 - Error creating the NDI Frame Sync for '%s' for '%s'",
-						recv_desc.source_to_connect_to.p_ndi_name, obs_source_name);
-					obs_log(LOG_DEBUG,
-						"'%s' ndi_source_thread: Cannot create ndi_frame_sync for NDI source '%s'",
-						obs_source_name, recv_desc.source_to_connect_to.p_ndi_name);
-					break;
-				}
-			}
-		}
+	if (ndi_frame_sync && s->config.genlock_enabled) {
 		//
-		// reset_ndi_receiver: END
+		// ndi_frame_sync, genlocked: the capture clock thread captures and outputs the frames, this loop only
+		// keeps managing the receiver.
 		//
-
+		ndi_source_genlock_set(s, ndi_frame_sync);
+		*next_run_ns = os_gettime_ns() + 100000000ULL;
+	} else if (ndi_frame_sync) {
 		//
-		// Now that we have a stable usable ndi_receiver,
-		// check if there are any connections.
-		// If not then micro-pause and restart the loop.
+		// ndi_frame_sync
 		//
-		if (ndiLib->recv_get_no_connections(ndi_receiver) == 0) {
-#if 0
-			obs_log(LOG_DEBUG,
-				"'%s' ndi_source_thread: No connection; sleep and restart loop",
-				obs_source_name);
-#endif
-			process_empty_frame(s);
+		ndi_source_genlock_set(s, nullptr);
 
-			// This will also slow down the shutdown of OBS when no NDI feed is received.
-			std::this_thread::sleep_for(std::chrono::milliseconds(100));
-			continue;
+		if (framesync_next_capture_ns == 0) {
+			framesync_next_capture_ns = os_gettime_ns();
 		}
 
 		//
-		// Change PTZ: Realtime updated from Source settings UI
+		// Pull one OBS frame interval worth of audio samples per capture so that audio keeps up with the
+		// paced video capture.
 		//
-		if (s->config.ptz.enabled) {
-			const static float tollerance = 0.001f;
-			if (fabs(s->config.ptz.pan - ptz.pan) > tollerance ||
-			    fabs(s->config.ptz.tilt - ptz.tilt) > tollerance ||
-			    fabs(s->config.ptz.zoom - ptz.zoom) > tollerance) {
-				ptz = s->config.ptz;
-				if (ndiLib->recv_ptz_is_supported(ndi_receiver)) {
-					obs_log(LOG_DEBUG,
-						"'%s' ndi_source_thread: ptz changed; Sending PTZ pan=%f, tilt=%f, zoom=%f",
-						obs_source_name, //
-						ptz.pan, ptz.tilt, ptz.zoom);
-					ndiLib->recv_ptz_pan_tilt(ndi_receiver, ptz.pan, ptz.tilt);
-					ndiLib->recv_ptz_zoom(ndi_receiver, ptz.zoom);
-				}
-			}
-		}
+		ndi_source_framesync_capture(s, ndi_frame_sync, framesync_interval_ns);
+		ndi_source_framesync_output(s, ndi_frame_sync);
 
 		//
-		// Change Tally: Enable/Disable updated from Plugin settings UI
+		// Sleep until the next capture deadline, one OBS frame interval after the previous one.
+		// Sleeping to an absolute deadline subtracts the time spent in this iteration.
+		// If the thread fell behind by more than a frame (hidden source, no connection, slow
+		// output), re-anchor the schedule instead of bursting to catch up.
 		//
-#if 0
-		obs_log(LOG_DEBUG, "'%s' t{pre=%d,pro=%d}",
-			obs_source_name, //
-			s->config.tally2.on_preview,
-			s->config.tally2.on_program);
-#endif
-		if ((config->TallyPreviewEnabled && s->config.tally.on_preview != tally.on_preview) ||
-		    (config->TallyProgramEnabled && s->config.tally.on_program != tally.on_program)) {
-			tally.on_preview = s->config.tally.on_preview;
-			tally.on_program = s->config.tally.on_program;
-			obs_log(LOG_INFO, "'%s': Tally status : on_preview=%d, on_program=%d", obs_source_name,
-				tally.on_preview, tally.on_program);
-			obs_log(LOG_DEBUG,
-				"'%s' ndi_source_thread: tally changed; Sending tally on_preview=%d, on_program=%d",
-				obs_source_name, tally.on_preview, tally.on_program);
-			ndiLib->recv_set_tally(ndi_receiver, &tally);
+		framesync_next_capture_ns += framesync_interval_ns;
+		const uint64_t now = os_gettime_ns();
+		if (now > framesync_next_capture_ns + framesync_interval_ns) {
+			framesync_next_capture_ns = now;
 		}
-
+		*next_run_ns = framesync_next_capture_ns;
+	} else {
 		//
-		// If this source isn't showing in OBS then don't receive any frames from NDI. This occurs when multiple
-		// scenes have NDI sources that are not being shown and behavior is set to Keep Active. Without this check,
-		// the fps of OBS can decrease dramatically, especially with multiple 4K 60 sources.
+		// !ndi_frame_sync
 		//
-		if (!obs_source_showing(s->obs_source)) {
-			// Avoid busy-waiting when the source is hidden but kept active.
-			std::this_thread::sleep_for(std::chrono::milliseconds(5));
-			continue;
+		// Adaptive latency: output the buffered frames that are due, and do not block past the next one.
+		const bool adaptive_latency = s->config.latency == PROP_LATENCY_ADAPTIVE;
+		const uint64_t next_release_ns =
+			ndi_source_jitter_buffer_release(s, shared_receiver, !adaptive_latency);
+		uint32_t timeout_ms = capture_timeout_ms;
+		if (next_release_ns) {
+			const uint64_t now = os_gettime_ns();
+			const uint64_t release_in_ms =
+				next_release_ns > now ? (next_release_ns - now + 999999ULL) / 1000000ULL : 0;
+			timeout_ms = (uint32_t)std::min<uint64_t>(timeout_ms, release_in_ms);
 		}
 
-		if (ndi_frame_sync) {
-			//
-			// ndi_frame_sync
-			//
+		// Audio is captured by its own thread when it runs.
+		frame_received = ndiLib->recv_capture_v3(ndi_receiver, &video_frame,
+							 s->audio_thread_running ? nullptr : &audio_frame, nullptr,
+							 timeout_ms);
 
+		if (frame_received == NDIlib_frame_type_audio) {
 			//
 			// AUDIO
 			//
-			audio_frame = {};
-			ndiLib->framesync_capture_audio_v2(
-				ndi_frame_sync, &audio_frame,
-				0,     // "The desired sample rate. 0 to get the source value."
-				0,     // "The desired channel count. 0 to get the source value."
-				1024); // "The desired sample count. 0 to get the source value."
-			// Note: "This function will always return data immediately, inserting silence if no current audio data is present."
-			if (audio_frame.p_data && (audio_frame.timestamp > timestamp_audio)) {
-				timestamp_audio = audio_frame.timestamp;
-				// obs_log(LOG_DEBUG, "%s: New Audio Frame (Framesync ON): ts=%d tc=%d", obs_source_name, audio_frame.timestamp, audio_frame.timecode);
-				ndi_source_thread_process_audio3(&s->config, &audio_frame, s->obs_source,
-								 &obs_audio_frame);
-			}
-			ndiLib->framesync_free_audio_v2(ndi_frame_sync, &audio_frame);
+			// obs_log(LOG_DEBUG, "%s: New Audio Frame (Framesync OFF): ts=%d tc=%d", obs_source_name, audio_frame.timestamp, audio_frame.timecode);
+			if (adaptive_latency && ndi_source_jitter_buffer_push(s, shared_receiver, frame_received,
+									      nullptr, &audio_frame))
+				return true;
 
+			ndi_source_output_audio(s, shared_receiver, &audio_frame);
+
+			ndiLib->recv_free_audio_v3(ndi_receiver, &audio_frame);
+			return true;
+		}
+
+		if (frame_received == NDIlib_frame_type_video) {
 			//
 			// VIDEO
 			//
-			video_frame = {};
-			ndiLib->framesync_capture_video(ndi_frame_sync, &video_frame,
-							NDIlib_frame_format_type_progressive);
-			if (video_frame.p_data && (video_frame.timestamp > timestamp_video)) {
-				timestamp_video = video_frame.timestamp;
-				// obs_log(LOG_DEBUG, "%s: New Video Frame (Framesync ON): ts=%d tc=%d", obs_source_name, video_frame.timestamp, video_frame.timecode);
-				ndi_source_thread_process_video2(s, &video_frame, s->obs_source, &obs_video_frame);
+			if (video_frame.frame_rate_N > 0 && video_frame.frame_rate_D > 0) {
+				// Poll a few times per frame period when capturing without timeout.
+				poll_interval_ns = std::clamp<uint64_t>((uint64_t)video_frame.frame_rate_D *
+										1000000000ULL /
+										video_frame.frame_rate_N / 4,
+									1000000ULL, 10000000ULL);
 			}
-			ndiLib->framesync_free_video(ndi_frame_sync, &video_frame);
 
-			// TODO: More accurate sleep that subtracts the duration of this loop iteration?
-			std::this_thread::sleep_for(std::chrono::milliseconds(5));
-		} else {
 			//
-			// !ndi_frame_sync
+			// Lowest latency: the newest frame wins. Rather than replaying a backlog after a hiccup, skip
+			// the video frames already queued behind this one (audio stays queued and is processed next).
 			//
-			frame_received =
-				ndiLib->recv_capture_v3(ndi_receiver, &video_frame, &audio_frame, nullptr, 100);
-
-			if (frame_received == NDIlib_frame_type_audio) {
-				//
-				// AUDIO
-				//
-				// obs_log(LOG_DEBUG, "%s: New Audio Frame (Framesync OFF): ts=%d tc=%d", obs_source_name, audio_frame.timestamp, audio_frame.timecode);
-				ndi_source_thread_process_audio3(&s->config, &audio_frame, s->obs_source,
-								 &obs_audio_frame);
-
-				ndiLib->recv_free_audio_v3(ndi_receiver, &audio_frame);
-				continue;
+			if (s->config.latency == PROP_LATENCY_LOWEST) {
+				NDIlib_recv_queue_t queue = {};
+				ndiLib->recv_get_queue(ndi_receiver, &queue);
+				int discarded_frames = 0;
+				NDIlib_video_frame_v2_t newer_video_frame;
+				while (discarded_frames < queue.video_frames &&
+				       ndiLib->recv_capture_v3(ndi_receiver, &newer_video_frame, nullptr, nullptr, 0) ==
+					       NDIlib_frame_type_video) {
+					ndiLib->recv_free_video_v2(ndi_receiver, &video_frame);
+					video_frame = newer_video_frame;
+					discarded_frames++;
+				}
+				if (discarded_frames > 0) {
+					ndi_source_stats_add_discarded(s, discarded_frames);
+				}
 			}
+			// obs_log(LOG_DEBUG, "%s: New Video Frame (Framesync OFF): ts=%d tc=%d", obs_source_name, video_frame.timestamp, video_frame.timecode);
+			if (adaptive_latency && ndi_source_jitter_buffer_push(s, shared_receiver, frame_received,
+									      &video_frame, nullptr))
+				return true;
 
-			if (frame_received == NDIlib_frame_type_video) {
-				//
-				// VIDEO
-				//
-				// obs_log(LOG_DEBUG, "%s: New Video Frame (Framesync OFF): ts=%d tc=%d", obs_source_name, video_frame.timestamp, video_frame.timecode);
-				ndi_source_thread_process_video2(s, &video_frame, s->obs_source, &obs_video_frame);
+			ndi_source_output_video(s, shared_receiver, &video_frame);
 
-				ndiLib->recv_free_video_v2(ndi_receiver, &video_frame);
-				continue;
-			}
+			ndiLib->recv_free_video_v2(ndi_receiver, &video_frame);
+			return true;
+		}
 
-			if (frame_received == NDIlib_frame_type_none) {
-				process_empty_frame(s);
+		if (frame_received == NDIlib_frame_type_none) {
+			ndi_source_process_empty_frame(s, shared_receiver);
+			if (capture_timeout_ms == 0) {
+				// Zero-timeout capture (receive engine): poll again shortly instead of blocking.
+				*next_run_ns = os_gettime_ns() + poll_interval_ns;
+				if (next_release_ns && next_release_ns < *next_run_ns)
+					*next_run_ns = next_release_ns;
 			}
 		}
 	}
+
+	return true;
+}
+
+void ndi_source_receive_init(ndi_source_t *s)
+{
+	s->receiver = {};
+	s->receiver.recv_desc.allow_video_fields = true;
+	s->receiver.poll_interval_ns = 5000000ULL;
+	s->receiver.bandwidth = ndi_source_target_bandwidth(s);
+
+	pthread_mutex_lock(&s->stats_mutex);
+	s->stats = {};
+	pthread_mutex_unlock(&s->stats_mutex);
+
+	pthread_mutex_lock(&s->clock_mutex);
+	s->clock = {};
+	pthread_mutex_unlock(&s->clock_mutex);
+}
+
+void ndi_source_receive_cleanup(ndi_source_t *s)
+{
+	ndi_source_audio_thread_stop(s);
+	NDIFinder::unwatchPresence(s);
+	if (ndiLib)
+		ndi_source_jitter_buffer_clear(s);
+	ndi_receiver_instance_destroy(s, &s->receiver.pending);
+	ndi_receiver_instance_destroy(s, &s->receiver.current);
+	obs_log(LOG_DEBUG, "'%s' ndi_source_thread: Reset NDI Receiver", obs_source_get_name(s->obs_source));
+}
+
+//
+// Sleeps until `deadline_ns` (os_gettime_ns) unless the source is woken up or asked to stop in the meantime.
+//
+void ndi_source_wait_until(ndi_source_t *s, uint64_t deadline_ns)
+{
+	const uint64_t now = os_gettime_ns();
+	if (deadline_ns <= now)
+		return;
+
+	// os_event_timedwait has a millisecond resolution: wait for the whole milliseconds, sleep the remainder.
+	const auto wait_ms = (unsigned long)((deadline_ns - now) / 1000000ULL);
+	if (wait_ms > 0 && os_event_timedwait(s->wake_event, wait_ms) == 0)
+		return;
+	os_sleepto_ns(deadline_ns);
+}
+
+void *ndi_source_thread(void *data)
+{
+	auto s = (ndi_source_t *)data;
+	auto obs_source_name = obs_source_get_name(s->obs_source);
+	obs_log(LOG_DEBUG, "'%s' +ndi_source_thread(…)", obs_source_name);
+
+	//
+	// Main NDI receiver loop: BEGIN
+	//
+	while (os_event_try(s->stop_event) == EAGAIN) {
+		uint64_t next_run_ns = 0;
+		if (!ndi_source_receive_step(s, 100, &next_run_ns))
+			break;
+		if (next_run_ns)
+			ndi_source_wait_until(s, next_run_ns);
+	}
 	//
 	// Main NDI receiver loop: END
 	//
 
-	if (ndi_frame_sync) {
-		if (ndiLib) {
-			obs_log(LOG_DEBUG,
-				"'%s' ndi_source_thread: (out of loop) ndiLib->framesync_destroy(ndi_frame_sync)",
-				obs_source_name);
-			ndiLib->framesync_destroy(ndi_frame_sync);
-		}
-		ndi_frame_sync = nullptr; // TODO: Investigate if this should be put right after framesync_destroy() ?
-		obs_log(LOG_DEBUG, "'%s' ndi_source_thread: Reset NDI Frame Sync", obs_source_name);
-	}
-
-	if (ndi_receiver) {
-		if (ndiLib) {
-			obs_log(LOG_DEBUG, "'%s' ndi_source_thread: ndiLib->recv_destroy(ndi_receiver)",
-				obs_source_name);
-			ndiLib->recv_destroy(ndi_receiver);
-		}
-		obs_log(LOG_DEBUG, "'%s' ndi_source_thread: Reset NDI Receiver", obs_source_name);
-		ndi_receiver = nullptr;
-	}
+	ndi_source_receive_cleanup(s);
 
 	obs_log(LOG_DEBUG, "'%s' -ndi_source_thread(…)", obs_source_name);
 
 	return nullptr;
 }
 
-void ndi_source_thread_process_audio3(ndi_source_config_t *config, NDIlib_audio_frame_v3_t *ndi_audio_frame,
+bool ndi_source_receive_engine_step(void *data, uint64_t *next_run_ns)
+{
+	auto s = (ndi_source_t *)data;
+	if (os_event_try(s->stop_event) == 0)
+		return false;
+	return ndi_source_receive_step(s, 0, next_run_ns);
+}
+
+//
+// Maps an NDI timestamp (100 ns units, sender clock) of a video or audio frame to the local clock, see
+// `ndi_clock_recovery_t`. Frames without a timestamp are stamped with their local arrival time.
+//
+uint64_t ndi_source_recover_timestamp(ndi_source_t *source, int64_t ndi_timestamp, bool video)
+{
+	const uint64_t local_ns = os_gettime_ns();
+	if (ndi_timestamp == NDIlib_recv_timestamp_undefined)
+		return local_ns;
+
+	const int64_t sender_ns = ndi_timestamp * 100;
+
+	pthread_mutex_lock(&source->clock_mutex);
+	auto &clock = source->clock;
+	uint64_t timestamp_ns = local_ns;
+	const int64_t elapsed_ns = sender_ns - clock.base_sender_ns;
+	const double predicted_ns = clock.base_local_ns + (double)elapsed_ns * clock.rate;
+	const double error_ns = (double)local_ns - predicted_ns;
+	const bool drives_clock =
+		video || !clock.locked || local_ns - clock.video_update_ns > CLOCK_RECOVERY_VIDEO_TIMEOUT_NS;
+	if (!drives_clock) {
+		// Mapped through the estimate; a sender clock jump is left to the driving stream to re-lock.
+		if (fabs(error_ns) < CLOCK_RECOVERY_DISCONTINUITY_NS)
+			timestamp_ns = (uint64_t)predicted_ns;
+	} else if (clock.locked && fabs(error_ns) < CLOCK_RECOVERY_DISCONTINUITY_NS) {
+		if (elapsed_ns >= CLOCK_RECOVERY_MIN_UPDATE_NS) {
+			clock.rate = std::clamp(clock.rate + CLOCK_RECOVERY_KI * error_ns / (double)elapsed_ns,
+						1.0 - CLOCK_RECOVERY_MAX_RATE_DEVIATION,
+						1.0 + CLOCK_RECOVERY_MAX_RATE_DEVIATION);
+		}
+		clock.base_local_ns = predicted_ns + CLOCK_RECOVERY_KP * error_ns;
+		clock.base_sender_ns = sender_ns;
+		timestamp_ns = (uint64_t)clock.base_local_ns;
+	} else {
+		if (clock.locked) {
+			obs_log(LOG_INFO, "'%s': NDI sender clock jumped by %.1f ms, re-locking clock recovery",
+				obs_source_get_name(source->obs_source), error_ns / 1000000.0);
+		}
+		clock.locked = true;
+		clock.base_sender_ns = sender_ns;
+		clock.base_local_ns = (double)local_ns;
+		clock.rate = 1.0;
+	}
+	if (drives_clock && video)
+		clock.video_update_ns = local_ns;
+	pthread_mutex_unlock(&source->clock_mutex);
+
+	return timestamp_ns;
+}
+
+void ndi_source_thread_process_audio3(ndi_source_t *source, NDIlib_audio_frame_v3_t *ndi_audio_frame,
 				      obs_source_t *obs_source, obs_source_audio *obs_audio_frame)
 {
+	auto config = &source->config;
 	if (!config->audio_enabled) {
 		return;
 	}
 
-	const int channelCount = ndi_audio_frame->no_channels > 8 ? 8 : ndi_audio_frame->no_channels;
+	//
+	// Channel routing: downmix or map the NDI channels to the OBS channels, or pass the first 8 through.
+	//
+	obs_audio_info oai;
+	const int obs_channels = obs_get_audio_info(&oai) ? (int)get_audio_channels(oai.speakers) : 2;
+
+	pthread_mutex_lock(&source->audio_routing_mutex);
+	auto routing = source->audio_routing;
+	int channelCount;
+	if (ndi_audio_routing_prepare(routing, ndi_audio_frame->no_channels, obs_channels)) {
+		ndi_audio_routing_apply(routing, ndi_audio_frame->p_data, ndi_audio_frame->channel_stride_in_bytes,
+					ndi_audio_frame->no_samples, obs_audio_frame->data);
+		channelCount = routing->output_channels;
+	} else {
+		channelCount = ndi_audio_frame->no_channels > 8 ? 8 : ndi_audio_frame->no_channels;
+		for (int i = 0; i < channelCount; ++i) {
+			obs_audio_frame->data[i] =
+				(uint8_t *)ndi_audio_frame->p_data + (i * ndi_audio_frame->channel_stride_in_bytes);
+		}
+	}
 
 	obs_audio_frame->speakers = channel_count_to_layout(channelCount);
 
@@ -775,17 +2203,234 @@ void ndi_source_thread_process_audio3(ndi_source_config_t *config, NDIlib_audio_
 	case PROP_SYNC_NDI_SOURCE_TIMECODE:
 		obs_audio_frame->timestamp = (uint64_t)(ndi_audio_frame->timecode * 100);
 		break;
+
+	case PROP_SYNC_NDI_CLOCK_RECOVERY:
+		obs_audio_frame->timestamp = ndi_source_recover_timestamp(source, ndi_audio_frame->timestamp, false);
+		break;
 	}
 
 	obs_audio_frame->samples_per_sec = ndi_audio_frame->sample_rate;
 	obs_audio_frame->format = AUDIO_FORMAT_FLOAT_PLANAR;
 	obs_audio_frame->frames = ndi_audio_frame->no_samples;
-	for (int i = 0; i < channelCount; ++i) {
-		obs_audio_frame->data[i] =
-			(uint8_t *)ndi_audio_frame->p_data + (i * ndi_audio_frame->channel_stride_in_bytes);
-	}
 
 	obs_source_output_audio(obs_source, obs_audio_frame);
+	pthread_mutex_unlock(&source->audio_routing_mutex);
+}
+
+static uint8_t *grow_buffer(uint8_t *&buffer, size_t &buffer_size, size_t size)
+{
+	if (buffer_size < size) {
+		bfree(buffer);
+		buffer = (uint8_t *)bmalloc(size);
+		buffer_size = size;
+	}
+	return buffer;
+}
+
+//
+// Returns the conversion buffer of the source, grown to at least `size` bytes.
+//
+uint8_t *ndi_source_video_buffer(ndi_source_t *source, size_t size)
+{
+	return grow_buffer(source->video_buffer, source->video_buffer_size, size);
+}
+
+//
+// UYVA is a UYVY plane followed by an alpha plane of `line_stride_in_bytes / 2` bytes per row.
+// OBS takes it as planar I42A: the UYVY plane is deinterleaved into the conversion buffer of the source, the
+// alpha plane is used in place.
+//
+void ndi_source_video_uyva_to_i42a(ndi_source_t *source, NDIlib_video_frame_v2_t *ndi_video_frame,
+				   obs_source_frame *obs_video_frame)
+{
+	const uint32_t width = (uint32_t)ndi_video_frame->xres;
+	const uint32_t height = (uint32_t)ndi_video_frame->yres;
+	const size_t src_linesize = (size_t)ndi_video_frame->line_stride_in_bytes;
+	const size_t y_linesize = ((size_t)width + 31) & ~(size_t)31;
+	const size_t uv_linesize = y_linesize / 2;
+
+	uint8_t *y = ndi_source_video_buffer(source, y_linesize * height * 2);
+	uint8_t *u = y + y_linesize * height;
+	uint8_t *v = u + uv_linesize * height;
+	const uint8_t *alpha = ndi_video_frame->p_data + src_linesize * height;
+	ndi_video_uyvy_to_i422(ndi_video_frame->p_data, src_linesize, y, y_linesize, u, v, uv_linesize, width, height);
+	if (source->config.unpremultiply_enabled) {
+		ndi_video_unpremultiply_i422(y, y_linesize, u, v, uv_linesize, alpha, src_linesize / 2, width, height,
+					     source->config.yuv_range == VIDEO_RANGE_FULL);
+	}
+
+	obs_video_frame->data[0] = y;
+	obs_video_frame->data[1] = u;
+	obs_video_frame->data[2] = v;
+	obs_video_frame->data[3] = (uint8_t *)alpha;
+	obs_video_frame->linesize[0] = (uint32_t)y_linesize;
+	obs_video_frame->linesize[1] = (uint32_t)uv_linesize;
+	obs_video_frame->linesize[2] = (uint32_t)uv_linesize;
+	obs_video_frame->linesize[3] = (uint32_t)(src_linesize / 2);
+}
+
+//
+// Crops the frame by offsetting its plane pointers (the line sizes are kept), so that only the region of interest
+// is copied by OBS and uploaded. Offsets and sizes are kept even for the chroma subsampled formats.
+//
+void ndi_source_video_crop(ndi_source_t *source, obs_source_frame *obs_video_frame)
+{
+	const auto &config = source->config;
+	if (!config.crop_left && !config.crop_top && !config.crop_right && !config.crop_bottom)
+		return;
+	if (obs_video_frame->width < 4 || obs_video_frame->height < 4)
+		return;
+
+	// Keep at least 2x2 pixels.
+	const uint32_t left = std::min<uint32_t>(config.crop_left & ~1, obs_video_frame->width - 2);
+	const uint32_t top = std::min<uint32_t>(config.crop_top & ~1, obs_video_frame->height - 2);
+	const uint32_t right = std::min<uint32_t>(config.crop_right, obs_video_frame->width - left - 2);
+	const uint32_t bottom = std::min<uint32_t>(config.crop_bottom, obs_video_frame->height - top - 2);
+
+	auto crop_plane = [&](int plane, size_t bytes_per_pixel, uint32_t x_subsampling, uint32_t y_subsampling) {
+		obs_video_frame->data[plane] += (size_t)(top / y_subsampling) * obs_video_frame->linesize[plane] +
+						(left / x_subsampling) * bytes_per_pixel;
+	};
+	switch (obs_video_frame->format) {
+	case VIDEO_FORMAT_BGRA:
+	case VIDEO_FORMAT_BGRX:
+	case VIDEO_FORMAT_RGBA:
+		crop_plane(0, 4, 1, 1);
+		break;
+	case VIDEO_FORMAT_UYVY:
+		crop_plane(0, 2, 1, 1);
+		break;
+	case VIDEO_FORMAT_I420:
+		crop_plane(0, 1, 1, 1);
+		crop_plane(1, 1, 2, 2);
+		crop_plane(2, 1, 2, 2);
+		break;
+	case VIDEO_FORMAT_NV12:
+		crop_plane(0, 1, 1, 1);
+		crop_plane(1, 2, 2, 2);
+		break;
+	case VIDEO_FORMAT_I42A:
+		crop_plane(0, 1, 1, 1);
+		crop_plane(1, 1, 2, 1);
+		crop_plane(2, 1, 2, 1);
+		crop_plane(3, 1, 1, 1);
+		break;
+	case VIDEO_FORMAT_P216:
+		crop_plane(0, 2, 1, 1);
+		crop_plane(1, 4, 2, 1);
+		break;
+	default:
+		return;
+	}
+
+	obs_video_frame->width = (obs_video_frame->width - left - right) & ~1u;
+	obs_video_frame->height = (obs_video_frame->height - top - bottom) & ~1u;
+}
+
+//
+// Downscales the frame by `config.downscale` (2 or 4) with a box filter, in steps of 2, before it is copied and
+// uploaded by OBS. The rows of each plane are split over the video conversion threads.
+// Formats without a downscale kernel are output at their native resolution.
+//
+void ndi_source_video_downscale(ndi_source_t *source, obs_source_frame *obs_video_frame)
+{
+	typedef struct plane_t {
+		int index;
+		// Size of the samples averaged together, bytes per pixel, and subsampling of the plane.
+		size_t group;
+		size_t bytes_per_pixel;
+		uint32_t x_subsampling;
+		uint32_t y_subsampling;
+	} plane_t;
+
+	std::vector<plane_t> planes;
+	switch (obs_video_frame->format) {
+	case VIDEO_FORMAT_BGRA:
+	case VIDEO_FORMAT_BGRX:
+	case VIDEO_FORMAT_RGBA:
+		planes = {{0, 4, 4, 1, 1}};
+		break;
+	case VIDEO_FORMAT_UYVY:
+		// Luma and chroma are interleaved: `group` 0 selects the UYVY kernel.
+		planes = {{0, 0, 2, 1, 1}};
+		break;
+	case VIDEO_FORMAT_I420:
+		planes = {{0, 1, 1, 1, 1}, {1, 1, 1, 2, 2}, {2, 1, 1, 2, 2}};
+		break;
+	case VIDEO_FORMAT_NV12:
+		planes = {{0, 1, 1, 1, 1}, {1, 2, 2, 2, 2}};
+		break;
+	case VIDEO_FORMAT_I42A:
+		planes = {{0, 1, 1, 1, 1}, {1, 1, 1, 2, 1}, {2, 1, 1, 2, 1}, {3, 1, 1, 1, 1}};
+		break;
+	default:
+		return;
+	}
+
+	size_t previous_step_size = 0;
+	for (int factor = source->config.downscale; factor > 1; factor /= 2) {
+		const uint32_t width = (obs_video_frame->width / 2) & ~1u;
+		const uint32_t height = (obs_video_frame->height / 2) & ~1u;
+		if (width < 2 || height < 2)
+			return;
+
+		// The first step writes at the start of the buffer, the second one right after it (each step is a
+		// quarter of the previous one, so twice the first step is enough for both).
+		uint8_t *dst = source->scaled_buffer + previous_step_size;
+		if (previous_step_size == 0) {
+			for (auto &plane : planes) {
+				const size_t row_bytes = (width / plane.x_subsampling) * plane.bytes_per_pixel;
+				previous_step_size += ((row_bytes + 31) & ~(size_t)31) * (height / plane.y_subsampling);
+			}
+			dst = grow_buffer(source->scaled_buffer, source->scaled_buffer_size, previous_step_size * 2);
+		}
+
+		for (auto &plane : planes) {
+			const size_t row_bytes = (width / plane.x_subsampling) * plane.bytes_per_pixel;
+			const size_t dst_linesize = (row_bytes + 31) & ~(size_t)31;
+			const uint32_t rows = height / plane.y_subsampling;
+			const uint8_t *src = obs_video_frame->data[plane.index];
+			const size_t src_linesize = obs_video_frame->linesize[plane.index];
+			ndi_video_parallel_for(rows, [&](uint32_t begin, uint32_t end) {
+				const uint8_t *band_src = src + begin * 2 * src_linesize;
+				uint8_t *band_dst = dst + begin * dst_linesize;
+				if (plane.group == 0) {
+					ndi_video_downscale2_uyvy(band_src, src_linesize, band_dst, dst_linesize,
+								  width, end - begin);
+				} else {
+					ndi_video_downscale2_plane(band_src, src_linesize, band_dst, dst_linesize,
+								   row_bytes, end - begin, plane.group);
+				}
+			});
+			obs_video_frame->data[plane.index] = dst;
+			obs_video_frame->linesize[plane.index] = (uint32_t)dst_linesize;
+			dst += dst_linesize * rows;
+		}
+		obs_video_frame->width = width;
+		obs_video_frame->height = height;
+	}
+}
+
+//
+// Applies the staged color settings to the output frame. The frame is written by the thread outputting it, which
+// is not always the receive loop: the capture clock outputs genlocked sources, and the capturer of a shared
+// receiver outputs all its subscribers.
+// The parameters are computed for the frame format, and again when the sender switches between 8-bit and
+// 16-bit (P216) frames: the limited range levels differ.
+//
+static void ndi_source_video_color(ndi_source_t *source, obs_source_frame *obs_video_frame)
+{
+	pthread_mutex_lock(&source->video_color_mutex);
+	if (source->video_color_changed || source->video_color_format != obs_video_frame->format) {
+		video_format_get_parameters_for_format(source->video_color_space, source->video_color_range,
+						       obs_video_frame->format, obs_video_frame->color_matrix,
+						       obs_video_frame->color_range_min,
+						       obs_video_frame->color_range_max);
+		obs_video_frame->trc = colorspace_to_trc(source->video_color_space);
+		source->video_color_changed = false;
+		source->video_color_format = obs_video_frame->format;
+	}
+	pthread_mutex_unlock(&source->video_color_mutex);
 }
 
 void ndi_source_thread_process_video2(ndi_source_t *source, NDIlib_video_frame_v2_t *ndi_video_frame,
@@ -806,10 +2451,13 @@ void ndi_source_thread_process_video2(ndi_source_t *source, NDIlib_video_frame_v
 		break;
 
 	case NDIlib_FourCC_type_UYVY:
-	case NDIlib_FourCC_type_UYVA:
 		obs_video_frame->format = VIDEO_FORMAT_UYVY;
 		break;
 
+	case NDIlib_FourCC_type_UYVA:
+		obs_video_frame->format = VIDEO_FORMAT_I42A;
+		break;
+
 	case NDIlib_FourCC_type_I420:
 		obs_video_frame->format = VIDEO_FORMAT_I420;
 		break;
@@ -818,6 +2466,11 @@ void ndi_source_thread_process_video2(ndi_source_t *source, NDIlib_video_frame_v
 		obs_video_frame->format = VIDEO_FORMAT_NV12;
 		break;
 
+	case NDIlib_FourCC_type_P216:
+	case NDIlib_FourCC_type_PA16:
+		obs_video_frame->format = VIDEO_FORMAT_P216;
+		break;
+
 	default:
 		obs_log(LOG_ERROR, "ERR-430 - NDI Source uses an unsupported video pixel format: %d.",
 			ndi_video_frame->FourCC);
@@ -826,6 +2479,8 @@ void ndi_source_thread_process_video2(ndi_source_t *source, NDIlib_video_frame_v
 		break;
 	}
 
+	ndi_source_video_color(source, obs_video_frame);
+
 	auto config = &source->config;
 
 	switch (config->sync_mode) {
@@ -836,41 +2491,277 @@ void ndi_source_thread_process_video2(ndi_source_t *source, NDIlib_video_frame_v
 	case PROP_SYNC_NDI_SOURCE_TIMECODE:
 		obs_video_frame->timestamp = (uint64_t)(ndi_video_frame->timecode * 100);
 		break;
+
+	case PROP_SYNC_NDI_CLOCK_RECOVERY:
+		obs_video_frame->timestamp = ndi_source_recover_timestamp(source, ndi_video_frame->timestamp, true);
+		break;
 	}
 
-	source->width = ndi_video_frame->xres;
-	source->height = ndi_video_frame->yres;
 	source->last_frame_timestamp = obs_get_video_frame_time();
+	ndi_source_stats_video_frame(source, ndi_video_frame);
 
 	obs_video_frame->width = ndi_video_frame->xres;
 	obs_video_frame->height = ndi_video_frame->yres;
-	obs_video_frame->linesize[0] = ndi_video_frame->line_stride_in_bytes;
-	obs_video_frame->data[0] = ndi_video_frame->p_data;
+	if (ndi_video_frame->FourCC == NDIlib_FourCC_type_UYVA) {
+		ndi_source_video_uyva_to_i42a(source, ndi_video_frame, obs_video_frame);
+	} else if (ndi_video_frame->FourCC == NDIlib_FourCC_type_P216 ||
+		   ndi_video_frame->FourCC == NDIlib_FourCC_type_PA16) {
+		// 16-bit Y plane followed by the interleaved 16-bit CbCr plane, with the same stride: used in place.
+		// OBS has no 16-bit 4:2:2 format with alpha: the alpha plane that follows in PA16 is not used, the
+		// YUV 4:2:2 + alpha receive format keeps it (in 8 bits).
+		const uint32_t linesize = (uint32_t)ndi_video_frame->line_stride_in_bytes;
+		obs_video_frame->data[0] = ndi_video_frame->p_data;
+		obs_video_frame->data[1] = ndi_video_frame->p_data + (size_t)linesize * ndi_video_frame->yres;
+		obs_video_frame->linesize[0] = linesize;
+		obs_video_frame->linesize[1] = linesize;
+	} else if (source->config.unpremultiply_enabled && (ndi_video_frame->FourCC == NDIlib_FourCC_type_BGRA ||
+							    ndi_video_frame->FourCC == NDIlib_FourCC_type_RGBA)) {
+		// Straight alpha for OBS, converted into the buffer of the source: a shared receiver may feed the
+		// same frame to other sources.
+		const size_t linesize = (size_t)ndi_video_frame->line_stride_in_bytes;
+		uint8_t *buffer = ndi_source_video_buffer(source, linesize * ndi_video_frame->yres);
+		ndi_video_unpremultiply_bgra(ndi_video_frame->p_data, linesize, buffer, linesize,
+					     (uint32_t)ndi_video_frame->xres, (uint32_t)ndi_video_frame->yres);
+		obs_video_frame->linesize[0] = (uint32_t)linesize;
+		obs_video_frame->data[0] = buffer;
+	} else {
+		const uint32_t linesize = (uint32_t)ndi_video_frame->line_stride_in_bytes;
+		const size_t luma_size = (size_t)linesize * ndi_video_frame->yres;
+		obs_video_frame->linesize[0] = linesize;
+		obs_video_frame->data[0] = ndi_video_frame->p_data;
+		if (ndi_video_frame->FourCC == NDIlib_FourCC_type_I420) {
+			// Y plane, then the U and V planes at half the stride and half the height.
+			obs_video_frame->data[1] = ndi_video_frame->p_data + luma_size;
+			obs_video_frame->data[2] =
+				obs_video_frame->data[1] + (size_t)(linesize / 2) * (ndi_video_frame->yres / 2);
+			obs_video_frame->linesize[1] = linesize / 2;
+			obs_video_frame->linesize[2] = linesize / 2;
+		} else if (ndi_video_frame->FourCC == NDIlib_FourCC_type_NV12) {
+			// Y plane, then the interleaved UV plane at half the height.
+			obs_video_frame->data[1] = ndi_video_frame->p_data + luma_size;
+			obs_video_frame->linesize[1] = linesize;
+		}
+	}
+
+	ndi_source_video_crop(source, obs_video_frame);
+	ndi_source_video_downscale(source, obs_video_frame);
+	source->width = obs_video_frame->width;
+	source->height = obs_video_frame->height;
 
 	obs_source_output_video(obs_source, obs_video_frame);
 }
 
+//
+// Called with `thread_mutex` held.
+//
 void ndi_source_thread_start(ndi_source_t *s)
 {
+	s->config.reset_ndi_receiver_ns = 0;
 	s->config.reset_ndi_receiver = true;
 	s->running = true;
-	pthread_create(&s->av_thread, nullptr, ndi_source_thread, s);
+	os_event_reset(s->stop_event);
+	ndi_source_receive_init(s);
+	s->uses_receive_engine = Config::Current()->ReceiveWorkerPoolEnabled;
+	if (s->uses_receive_engine) {
+		NDIReceiveEngine::Add(s, ndi_source_receive_engine_step);
+	} else {
+		pthread_create(&s->av_thread, nullptr, ndi_source_thread, s);
+	}
 	obs_log(LOG_INFO, "'Started Receiver Thread for OBS source: '%s' and NDI Source Name: %s'",
 		obs_source_get_name(s->obs_source), s->config.ndi_source_name);
 	obs_log(LOG_DEBUG, "'%s' ndi_source_thread_start: Started A/V ndi_source_thread for NDI source '%s'",
 		obs_source_get_name(s->obs_source), s->config.ndi_source_name);
 }
 
+//
+// Waits for the receive loop to exit after `stop_event` was signaled, and destroys its NDI receiver.
+// Called with `thread_mutex` held.
+//
+void ndi_source_thread_join(ndi_source_t *s)
+{
+	if (s->uses_receive_engine) {
+		NDIReceiveEngine::Remove(s);
+		ndi_source_receive_cleanup(s);
+	} else {
+		pthread_join(s->av_thread, NULL);
+	}
+	s->running = false;
+	s->warm = false;
+	auto obs_source = s->obs_source;
+	auto obs_source_name = obs_source_get_name(obs_source);
+	obs_log(LOG_DEBUG, "'%s' ndi_source_thread_stop: Stopped A/V ndi_source_thread for NDI source '%s'",
+		obs_source_name, s->config.ndi_source_name);
+}
+
+//
+// Called with `thread_mutex` held.
+//
 void ndi_source_thread_stop(ndi_source_t *s)
 {
 	if (s->running) {
-		s->running = false;
-		pthread_join(s->av_thread, NULL);
-		auto obs_source = s->obs_source;
-		auto obs_source_name = obs_source_get_name(obs_source);
-		obs_log(LOG_DEBUG, "'%s' ndi_source_thread_stop: Stopped A/V ndi_source_thread for NDI source '%s'",
-			obs_source_name, s->config.ndi_source_name);
+		os_event_signal(s->stop_event);
+		os_event_signal(s->wake_event);
+		ndi_source_thread_join(s);
+	}
+}
+
+//
+// Registry of all NDI sources, so that their receivers can be stopped at once.
+//
+static std::vector<ndi_source_t *> ndi_sources;
+static std::mutex ndi_sources_mutex;
+
+//
+// Joins the receive loops of `sources` in parallel after their `stop_event` was signaled, then unlocks their
+// `thread_mutex`, locked by the caller.
+//
+static void ndi_source_thread_join_all(const std::vector<ndi_source_t *> &sources)
+{
+	std::vector<std::thread> joiners;
+	joiners.reserve(sources.size());
+	for (auto s : sources) {
+		joiners.emplace_back(ndi_source_thread_join, s);
+	}
+	for (auto &joiner : joiners) {
+		joiner.join();
 	}
+	for (auto s : sources) {
+		pthread_mutex_unlock(&s->thread_mutex);
+	}
+}
+
+//
+// Stops the receivers of all NDI sources in parallel, instead of one after the other as OBS destroys them.
+// Called when OBS exits or switches scene collection.
+//
+void ndi_source_stop_all()
+{
+	// Held until all receivers are stopped: `ndi_source_destroy` waits for it before freeing its source.
+	std::lock_guard<std::mutex> lock(ndi_sources_mutex);
+
+	// The `thread_mutex` of running sources stays locked until they are joined.
+	std::vector<ndi_source_t *> running_sources;
+	for (auto s : ndi_sources) {
+		pthread_mutex_lock(&s->thread_mutex);
+		if (s->running)
+			running_sources.push_back(s);
+		else
+			pthread_mutex_unlock(&s->thread_mutex);
+	}
+	if (running_sources.empty())
+		return;
+
+	const uint64_t start_ns = os_gettime_ns();
+
+	for (auto s : running_sources) {
+		os_event_signal(s->stop_event);
+		os_event_signal(s->wake_event);
+	}
+
+	ndi_source_thread_join_all(running_sources);
+
+	obs_log(LOG_INFO, "Stopped %zu NDI source receivers in %.1f ms", running_sources.size(),
+		(double)(os_gettime_ns() - start_ns) / 1000000.0);
+}
+
+//
+// Appends the sources of the visible items of a scene or group, recursing into nested scenes and groups.
+//
+static void ndi_source_collect_scene_sources(obs_source_t *scene_source, std::vector<obs_source_t *> &sources)
+{
+	auto scene = obs_scene_from_source(scene_source);
+	if (!scene)
+		scene = obs_group_from_source(scene_source);
+	if (!scene)
+		return;
+
+	obs_scene_enum_items(
+		scene,
+		[](obs_scene_t *, obs_sceneitem_t *item, void *param) {
+			auto sources = (std::vector<obs_source_t *> *)param;
+			if (obs_sceneitem_visible(item)) {
+				auto source = obs_sceneitem_get_source(item);
+				sources->push_back(source);
+				ndi_source_collect_scene_sources(source, *sources);
+			}
+			return true;
+		},
+		&sources);
+}
+
+//
+// Pre-connects the receivers of the NDI sources in `scenes` (the likely next scenes, most likely first), so that
+// they are already connected when a transition shows them instead of showing black while NDI negotiates.
+// At most `budget` receivers are kept warm, at the lowest bandwidth until shown. Warm receivers of sources that
+// are no longer in these scenes are stopped, unless the source is showing or kept active.
+//
+void ndi_source_preconnect_scenes(const std::vector<obs_source_t *> &scenes, int budget)
+{
+	std::vector<obs_source_t *> scene_sources;
+	for (auto scene : scenes) {
+		ndi_source_collect_scene_sources(scene, scene_sources);
+	}
+
+	// Warm receivers to stop; their `thread_mutex` stays locked until they are joined, after `ndi_sources_mutex`
+	// is released, so that `ndi_source_destroy` waits for them before freeing their source.
+	std::vector<ndi_source_t *> stopping;
+	{
+		std::lock_guard<std::mutex> lock(ndi_sources_mutex);
+
+		// Candidates in scene order; sources already receiving for another reason don't count against the
+		// budget.
+		std::vector<ndi_source_t *> candidates;
+		for (auto source : scene_sources) {
+			if ((int)candidates.size() >= budget)
+				break;
+			auto it = std::find_if(ndi_sources.begin(), ndi_sources.end(),
+					       [source](ndi_source_t *s) { return s->obs_source == source; });
+			if (it == ndi_sources.end())
+				continue;
+			auto s = *it;
+			pthread_mutex_lock(&s->thread_mutex);
+			const bool in_use = s->running && !s->warm;
+			pthread_mutex_unlock(&s->thread_mutex);
+			if (in_use || strlen(s->config.ndi_source_name) == 0 || obs_source_showing(s->obs_source) ||
+			    std::find(candidates.begin(), candidates.end(), s) != candidates.end())
+				continue;
+			candidates.push_back(s);
+		}
+
+		for (auto s : ndi_sources) {
+			if (std::find(candidates.begin(), candidates.end(), s) != candidates.end())
+				continue;
+			pthread_mutex_lock(&s->thread_mutex);
+			if (s->warm) {
+				s->warm = false;
+				if (s->running && !obs_source_showing(s->obs_source) &&
+				    s->config.behavior != PROP_BEHAVIOR_KEEP_ACTIVE) {
+					obs_log(LOG_DEBUG,
+						"'%s' ndi_source_preconnect_scenes: Stopping pre-connected receiver.",
+						obs_source_get_name(s->obs_source));
+					os_event_signal(s->stop_event);
+					os_event_signal(s->wake_event);
+					stopping.push_back(s);
+					continue;
+				}
+			}
+			pthread_mutex_unlock(&s->thread_mutex);
+		}
+
+		for (auto s : candidates) {
+			pthread_mutex_lock(&s->thread_mutex);
+			if (!s->running) {
+				obs_log(LOG_DEBUG,
+					"'%s' ndi_source_preconnect_scenes: Pre-connecting receiver to '%s'.",
+					obs_source_get_name(s->obs_source), s->config.ndi_source_name);
+				ndi_source_thread_start(s);
+				s->warm = true;
+			}
+			pthread_mutex_unlock(&s->thread_mutex);
+		}
+	}
+
+	ndi_source_thread_join_all(stopping);
 }
 
 int safe_strcmp(const char *str1, const char *str2)
@@ -934,6 +2825,13 @@ void ndi_source_update(void *data, obs_data_t *settings)
 		obs_source_name, new_latency, s->config.latency);
 	s->config.latency = new_latency;
 
+	auto new_recv_format = (int)obs_data_get_int(settings, PROP_RECV_FORMAT);
+	reset_ndi_receiver |= (s->config.recv_format != new_recv_format);
+	obs_log(LOG_DEBUG,
+		"'%s' ndi_source_update: Check for 'Receive format' setting changes: new_recv_format='%d' vs config.recv_format='%d'",
+		obs_source_name, new_recv_format, s->config.recv_format);
+	s->config.recv_format = new_recv_format;
+
 	auto new_framesync_enabled = obs_data_get_bool(settings, PROP_FRAMESYNC);
 	reset_ndi_receiver |= (s->config.framesync_enabled != new_framesync_enabled);
 	obs_log(LOG_DEBUG,
@@ -950,6 +2848,14 @@ void ndi_source_update(void *data, obs_data_t *settings)
 		s->config.hw_accel_enabled ? "true" : "false");
 	s->config.hw_accel_enabled = new_hw_accel_enabled;
 
+	auto new_shared_receiver_enabled = obs_data_get_bool(settings, PROP_SHARED_RECEIVER);
+	reset_ndi_receiver |= (s->config.shared_receiver_enabled != new_shared_receiver_enabled);
+	obs_log(LOG_DEBUG,
+		"'%s' ndi_source_update: Check for 'Shared Receiver' setting changes: new_shared_receiver_enabled='%s' vs config.shared_receiver_enabled='%s'",
+		obs_source_name, new_shared_receiver_enabled ? "true" : "false",
+		s->config.shared_receiver_enabled ? "true" : "false");
+	s->config.shared_receiver_enabled = new_shared_receiver_enabled;
+
 	auto new_yuv_range = prop_to_range_type((int)obs_data_get_int(settings, PROP_YUV_RANGE));
 	reset_ndi_receiver |= (s->config.yuv_range != new_yuv_range);
 	obs_log(LOG_DEBUG,
@@ -1023,11 +2929,21 @@ void ndi_source_update(void *data, obs_data_t *settings)
 
 	s->config.timeout_action = obs_data_get_int(settings, PROP_TIMEOUT);
 
-	// Clean the source content when settings change unless requested otherwise.
+	// Applied by the receive loop.
+	s->config.audio_thread_enabled = obs_data_get_bool(settings, PROP_AUDIO_THREAD);
+
+	// Applied by the receive loop, see `ndi_source_target_bandwidth`.
+	s->config.hidden_standby_enabled = obs_data_get_bool(settings, PROP_HIDDEN_STANDBY);
+
+	s->config.genlock_enabled = obs_data_get_bool(settings, PROP_FRAMESYNC_GENLOCK);
+
+	s->config.unpremultiply_enabled = obs_data_get_bool(settings, PROP_UNPREMULTIPLY);
+
+	// Clean the source content when the receiver settings change unless requested otherwise.
 	// Always clean if the source is set to Audio Only.
-	// Always clean if the receiver is reset as well.
-	if (s->config.bandwidth == PROP_BW_AUDIO_ONLY || s->config.behavior == PROP_BEHAVIOR_STOP_RESUME_BLANK ||
-	    reset_ndi_receiver) {
+	// A receiver reset does not clean: the current frame stays until the new receiver delivers one.
+	if (reset_ndi_receiver &&
+	    (s->config.bandwidth == PROP_BW_AUDIO_ONLY || s->config.behavior == PROP_BEHAVIOR_STOP_RESUME_BLANK)) {
 		obs_log(LOG_DEBUG,
 			"'%s' ndi_source_update: Deactivate source output video (Actively reset the frame content)",
 			obs_source_name);
@@ -1060,19 +2976,44 @@ void ndi_source_update(void *data, obs_data_t *settings)
 		}
 	}
 
-	// Disable OBS buffering only for "Lowest" latency mode
-	const bool is_unbuffered = (s->config.latency == PROP_LATENCY_LOWEST);
+	// Disable OBS buffering for "Lowest" latency mode, and for "Adaptive" latency mode which presents the frames
+	// itself (see `ndi_source_jitter_buffer_t`). FrameSync captures bypass that buffer, so Adaptive latency with
+	// FrameSync is left to the OBS buffering.
+	const bool is_unbuffered = (s->config.latency == PROP_LATENCY_LOWEST ||
+				    (s->config.latency == PROP_LATENCY_ADAPTIVE && !s->config.framesync_enabled));
 	obs_source_set_async_unbuffered(obs_source, is_unbuffered);
 
 	s->config.audio_enabled = obs_data_get_bool(settings, PROP_AUDIO);
 	obs_source_set_audio_active(obs_source, s->config.audio_enabled);
 
+	s->config.audio_routing = (int)obs_data_get_int(settings, PROP_AUDIO_ROUTING);
+	std::vector<std::vector<int>> audio_routing_map;
+	if (s->config.audio_routing == NDI_AUDIO_ROUTING_MAP &&
+	    !ndi_audio_routing_parse_map(obs_data_get_string(settings, PROP_AUDIO_ROUTING_MAP), audio_routing_map)) {
+		obs_log(LOG_WARNING, "'%s': Invalid audio channel map '%s', passing the first channels through",
+			obs_source_name, obs_data_get_string(settings, PROP_AUDIO_ROUTING_MAP));
+	}
+	pthread_mutex_lock(&s->audio_routing_mutex);
+	ndi_audio_routing_configure(s->audio_routing, s->config.audio_routing, audio_routing_map);
+	pthread_mutex_unlock(&s->audio_routing_mutex);
+
 	bool ptz_enabled = obs_data_get_bool(settings, PROP_PTZ);
 	float pan = (float)obs_data_get_double(settings, PROP_PAN);
 	float tilt = (float)obs_data_get_double(settings, PROP_TILT);
 	float zoom = (float)obs_data_get_double(settings, PROP_ZOOM);
 	s->config.ptz = ptz_t(ptz_enabled, pan, tilt, zoom);
 
+	const bool crop_enabled = obs_data_get_bool(settings, PROP_CROP);
+	s->config.crop_left = crop_enabled ? (int)obs_data_get_int(settings, PROP_CROP_LEFT) : 0;
+	s->config.crop_top = crop_enabled ? (int)obs_data_get_int(settings, PROP_CROP_TOP) : 0;
+	s->config.crop_right = crop_enabled ? (int)obs_data_get_int(settings, PROP_CROP_RIGHT) : 0;
+	s->config.crop_bottom = crop_enabled ? (int)obs_data_get_int(settings, PROP_CROP_BOTTOM) : 0;
+
+	const int downscale = (int)obs_data_get_int(settings, PROP_DOWNSCALE);
+	s->config.downscale = downscale >= 4 ? 4 : downscale >= 2 ? 2 : 1;
+
+	s->config.max_fps = (int)obs_data_get_int(settings, PROP_MAX_FPS);
+
 	// Update tally status
 	s->config.tally.on_preview = tally_on_preview(obs_source);
 	s->config.tally.on_program = tally_on_program(obs_source);
@@ -1080,15 +3021,26 @@ void ndi_source_update(void *data, obs_data_t *settings)
 	if (strlen(s->config.ndi_source_name) == 0) {
 		obs_log(LOG_DEBUG, "'%s' ndi_source_update: No NDI Source selected; Requesting Source Thread Stop.",
 			obs_source_name);
+		pthread_mutex_lock(&s->thread_mutex);
 		ndi_source_thread_stop(s);
+		pthread_mutex_unlock(&s->thread_mutex);
 	} else {
 		obs_log(LOG_DEBUG, "'%s' ndi_source_update: NDI Source '%s' selected.", obs_source_name,
 			s->config.ndi_source_name);
+		pthread_mutex_lock(&s->thread_mutex);
 		if (s->running) {
 			//
-			// Thread is running; notify it if it needs to reset the NDI receiver
+			// Thread is running; notify it if it needs to reset the NDI receiver.
+			// Each edit postpones the reset, and an edit that does not need one keeps a pending one.
+			// The receive loop compares the resulting settings with the current receiver, so edits that
+			// cancel each other out leave it untouched.
 			//
-			s->config.reset_ndi_receiver = reset_ndi_receiver;
+			if (reset_ndi_receiver) {
+				s->config.reset_ndi_receiver_ns = os_gettime_ns() + RECEIVER_RESET_DEBOUNCE_NS;
+				s->config.reset_ndi_receiver = true;
+			}
+			// Apply the new settings promptly, even if the receive loop is backing off without connection.
+			ndi_source_wake(s);
 		} else {
 			//
 			// Thread is not running; start it if either:
@@ -1102,14 +3054,17 @@ void ndi_source_update(void *data, obs_data_t *settings)
 				ndi_source_thread_start(s);
 			}
 		}
+		pthread_mutex_unlock(&s->thread_mutex);
 	}
 	// Provide all the source config when updated
 	obs_log(LOG_INFO,
-		"NDI Source Updated: '%s', 'Bandwidth'='%d', Latency='%d', Framesync='%s', HardwareAcceleration='%s', behavior='%d', timeoutmode='%d', sync_mode='%d', yuv_range='%d', yuv_colorspace='%d'",
+		"NDI Source Updated: '%s', 'Bandwidth'='%d', Latency='%d', Framesync='%s', HardwareAcceleration='%s', SharedReceiver='%s', HiddenStandby='%s', behavior='%d', timeoutmode='%d', sync_mode='%d', yuv_range='%d', yuv_colorspace='%d'",
 		s->config.ndi_source_name, s->config.bandwidth, s->config.latency,
 		s->config.framesync_enabled ? "enabled" : "disabled",
-		s->config.hw_accel_enabled ? "enabled" : "disabled", s->config.behavior, s->config.timeout_action,
-		s->config.sync_mode, s->config.yuv_range, s->config.yuv_colorspace);
+		s->config.hw_accel_enabled ? "enabled" : "disabled",
+		s->config.shared_receiver_enabled ? "enabled" : "disabled",
+		s->config.hidden_standby_enabled ? "enabled" : "disabled", s->config.behavior,
+		s->config.timeout_action, s->config.sync_mode, s->config.yuv_range, s->config.yuv_colorspace);
 
 	obs_log(LOG_DEBUG, "'%s' -ndi_source_update(…)", obs_source_name);
 }
@@ -1121,10 +3076,14 @@ void ndi_source_shown(void *data)
 	auto obs_source_name = obs_source_get_name(s->obs_source);
 	obs_log(LOG_DEBUG, "'%s' ndi_source_shown(…)", obs_source_name);
 	s->config.tally.on_preview = tally_on_preview(s->obs_source);
+	pthread_mutex_lock(&s->thread_mutex);
+	// A pre-connected receiver is now in use, it is stopped when hidden like any other.
+	s->warm = false;
 	if (!s->running) {
 		obs_log(LOG_DEBUG, "'%s' ndi_source_shown: Requesting Source Thread Start.", obs_source_name);
 		ndi_source_thread_start(s);
 	}
+	pthread_mutex_unlock(&s->thread_mutex);
 }
 
 void ndi_source_hidden(void *data)
@@ -1134,12 +3093,14 @@ void ndi_source_hidden(void *data)
 	auto obs_source_name = obs_source_get_name(s->obs_source);
 	obs_log(LOG_DEBUG, "'%s' ndi_source_hidden(…)", obs_source_name);
 	s->config.tally.on_preview = false;
+	pthread_mutex_lock(&s->thread_mutex);
 	if (s->running && s->config.behavior != PROP_BEHAVIOR_KEEP_ACTIVE) {
 		obs_log(LOG_DEBUG, "'%s' ndi_source_hidden: Requesting Source Thread Stop.", obs_source_name);
 		// Stopping the thread may result in `on_preview=false` not getting sent,
 		// but the thread's `ndiLib->recv_destroy` results in an implicit tally off.
 		ndi_source_thread_stop(s);
 	}
+	pthread_mutex_unlock(&s->thread_mutex);
 }
 
 void ndi_source_activated(void *data)
@@ -1149,10 +3110,16 @@ void ndi_source_activated(void *data)
 	obs_log(LOG_DEBUG, "'%s' ndi_source_activated(…)", obs_source_name);
 	s->config.tally.on_preview = tally_on_preview(s->obs_source);
 	s->config.tally.on_program = tally_on_program(s->obs_source);
+	pthread_mutex_lock(&s->thread_mutex);
+	s->warm = false;
 	if (!s->running) {
 		obs_log(LOG_DEBUG, "'%s' ndi_source_activated: Requesting Source Thread Start.", obs_source_name);
 		ndi_source_thread_start(s);
+	} else {
+		// Auto bandwidth follows the program state, see `ndi_source_target_bandwidth`.
+		ndi_source_wake(s);
 	}
+	pthread_mutex_unlock(&s->thread_mutex);
 }
 
 void ndi_source_deactivated(void *data)
@@ -1161,6 +3128,11 @@ void ndi_source_deactivated(void *data)
 	obs_log(LOG_DEBUG, "'%s' ndi_source_deactivated(…)", obs_source_get_name(s->obs_source));
 	s->config.tally.on_preview = tally_on_preview(s->obs_source);
 	s->config.tally.on_program = false;
+	// Auto bandwidth follows the program state, see `ndi_source_target_bandwidth`.
+	pthread_mutex_lock(&s->thread_mutex);
+	if (s->running)
+		ndi_source_wake(s);
+	pthread_mutex_unlock(&s->thread_mutex);
 }
 
 void new_ndi_receiver_name(const char *obs_source_name, char **ndi_receiver_name)
@@ -1192,13 +3164,36 @@ void *ndi_source_create(obs_data_t *settings, obs_source_t *obs_source)
 
 	auto s = (ndi_source_t *)bzalloc(sizeof(ndi_source_t));
 	s->obs_source = obs_source;
+	pthread_mutex_init(&s->thread_mutex, nullptr);
+	pthread_mutex_init(&s->stats_mutex, nullptr);
+	pthread_mutex_init(&s->clock_mutex, nullptr);
+	pthread_mutex_init(&s->audio_routing_mutex, nullptr);
+	pthread_mutex_init(&s->video_color_mutex, nullptr);
+	s->audio_routing = new ndi_audio_routing_t();
+	os_event_init(&s->stop_event, OS_EVENT_TYPE_MANUAL);
+	os_event_init(&s->wake_event, OS_EVENT_TYPE_AUTO);
+	os_event_init(&s->audio_stop_event, OS_EVENT_TYPE_MANUAL);
 	new_ndi_receiver_name(obs_source_name, &(s->config.ndi_receiver_name));
 
 	auto sh = obs_source_get_signal_handler(s->obs_source);
 	signal_handler_connect(sh, "rename", on_ndi_source_renamed, s);
 
+	auto ph = obs_source_get_proc_handler(s->obs_source);
+	proc_handler_add(ph,
+			 "void get_receive_stats(out int video_frames_received, out int video_frames_dropped, "
+			 "out int video_frames_discarded, out int audio_frames_received, out int audio_frames_dropped, out int video_queue_depth, "
+			 "out int audio_queue_depth, out float video_jitter_ms, out float jitter_buffer_ms, out int width, "
+			 "out int height, "
+			 "out string fourcc, out float disconnected_s)",
+			 ndi_source_get_receive_stats, s);
+
 	ndi_source_update(s, settings);
 
+	{
+		std::lock_guard<std::mutex> lock(ndi_sources_mutex);
+		ndi_sources.push_back(s);
+	}
+
 	obs_log(LOG_DEBUG, "'%s' -ndi_source_create(…)", obs_source_name);
 
 	return s;
@@ -1213,7 +3208,14 @@ void ndi_source_destroy(void *data)
 	auto sh = obs_source_get_signal_handler(s->obs_source);
 	signal_handler_disconnect(sh, "rename", on_ndi_source_renamed, s);
 
+	{
+		std::lock_guard<std::mutex> lock(ndi_sources_mutex);
+		ndi_sources.erase(std::remove(ndi_sources.begin(), ndi_sources.end(), s), ndi_sources.end());
+	}
+
+	pthread_mutex_lock(&s->thread_mutex);
 	ndi_source_thread_stop(s);
+	pthread_mutex_unlock(&s->thread_mutex);
 
 	if (s->config.ndi_receiver_name) {
 		bfree(s->config.ndi_receiver_name);
@@ -1225,6 +3227,17 @@ void ndi_source_destroy(void *data)
 		s->config.ndi_source_name = nullptr;
 	}
 
+	pthread_mutex_destroy(&s->thread_mutex);
+	pthread_mutex_destroy(&s->stats_mutex);
+	pthread_mutex_destroy(&s->clock_mutex);
+	pthread_mutex_destroy(&s->audio_routing_mutex);
+	pthread_mutex_destroy(&s->video_color_mutex);
+	delete s->audio_routing;
+	bfree(s->video_buffer);
+	bfree(s->scaled_buffer);
+	os_event_destroy(s->stop_event);
+	os_event_destroy(s->wake_event);
+	os_event_destroy(s->audio_stop_event);
 	bfree(s);
 
 	obs_log(LOG_DEBUG, "'%s' -ndi_source_destroy(…)", obs_source_name);
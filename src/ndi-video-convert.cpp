@@ -0,0 +1,533 @@
+/******************************************************************************
+	Copyright (C) 2016-2024 DistroAV <contact@distroav.org>
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include "ndi-video-convert.h"
+
+#include "plugin-main.h"
+
+#include <util/platform.h>
+#include <util/threading.h>
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define NDI_VIDEO_CONVERT_SSE2
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define NDI_VIDEO_CONVERT_NEON
+#endif
+
+static void uyvy_row_to_i422(const uint8_t *src, uint8_t *y, uint8_t *u, uint8_t *v, uint32_t width)
+{
+	uint32_t x = 0;
+#if defined(NDI_VIDEO_CONVERT_SSE2)
+	// 16 pixels (32 bytes) per iteration: U0 Y0 V0 Y1 U1 Y2 V1 Y3 ...
+	const __m128i low_bytes = _mm_set1_epi16(0x00ff);
+	for (; x + 16 <= width; x += 16) {
+		const __m128i uyvy0 = _mm_loadu_si128((const __m128i *)(src + x * 2));
+		const __m128i uyvy1 = _mm_loadu_si128((const __m128i *)(src + x * 2 + 16));
+		const __m128i luma = _mm_packus_epi16(_mm_srli_epi16(uyvy0, 8), _mm_srli_epi16(uyvy1, 8));
+		const __m128i chroma =
+			_mm_packus_epi16(_mm_and_si128(uyvy0, low_bytes), _mm_and_si128(uyvy1, low_bytes));
+		const __m128i cb = _mm_packus_epi16(_mm_and_si128(chroma, low_bytes), _mm_setzero_si128());
+		const __m128i cr = _mm_packus_epi16(_mm_srli_epi16(chroma, 8), _mm_setzero_si128());
+		_mm_storeu_si128((__m128i *)(y + x), luma);
+		_mm_storel_epi64((__m128i *)(u + x / 2), cb);
+		_mm_storel_epi64((__m128i *)(v + x / 2), cr);
+	}
+#elif defined(NDI_VIDEO_CONVERT_NEON)
+	for (; x + 16 <= width; x += 16) {
+		const uint8x8x4_t uyvy = vld4_u8(src + x * 2);
+		const uint8x8x2_t luma = {{uyvy.val[1], uyvy.val[3]}};
+		vst2_u8(y + x, luma);
+		vst1_u8(u + x / 2, uyvy.val[0]);
+		vst1_u8(v + x / 2, uyvy.val[2]);
+	}
+#endif
+	for (; x + 2 <= width; x += 2) {
+		const uint8_t *p = src + x * 2;
+		u[x / 2] = p[0];
+		y[x] = p[1];
+		v[x / 2] = p[2];
+		y[x + 1] = p[3];
+	}
+}
+
+void ndi_video_uyvy_to_i422(const uint8_t *src, size_t src_linesize, uint8_t *dst_y, size_t dst_y_linesize,
+			    uint8_t *dst_u, uint8_t *dst_v, size_t dst_uv_linesize, uint32_t width, uint32_t height)
+{
+	for (uint32_t row = 0; row < height; ++row) {
+		uyvy_row_to_i422(src + row * src_linesize, dst_y + row * dst_y_linesize, dst_u + row * dst_uv_linesize,
+				 dst_v + row * dst_uv_linesize, width);
+	}
+}
+
+//
+// Straight color of a premultiplied one: round(c * 255 / a), clamped. Fully transparent pixels are black.
+// The SIMD paths compute c * 255 / a as a single correctly rounded float division, which rounds the same way.
+//
+static inline uint8_t unpremultiply(uint8_t c, uint8_t a)
+{
+	return a ? (uint8_t)std::min(255, (c * 255 + a / 2) / a) : 0;
+}
+
+static void unpremultiply_bgra_pixels(const uint8_t *src, uint8_t *dst, uint32_t x, uint32_t width)
+{
+	for (; x < width; ++x) {
+		const uint8_t *p = src + x * 4;
+		uint8_t *q = dst + x * 4;
+		const uint8_t a = p[3];
+		q[0] = unpremultiply(p[0], a);
+		q[1] = unpremultiply(p[1], a);
+		q[2] = unpremultiply(p[2], a);
+		q[3] = a;
+	}
+}
+
+//
+// SSE2 and AArch64 NEON paths; 32-bit ARM has no vector float division and uses the scalar path.
+//
+static void unpremultiply_bgra_row(const uint8_t *src, uint8_t *dst, uint32_t width)
+{
+	uint32_t x = 0;
+#if defined(NDI_VIDEO_CONVERT_SSE2)
+	// 4 pixels per iteration, one pixel per float vector. The alpha lane is passed through.
+	const __m128i zero = _mm_setzero_si128();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 half = _mm_set1_ps(0.5f);
+	const __m128 max = _mm_set1_ps(255.0f);
+	const __m128 color_lanes = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+	auto unpremultiply_pixel = [&](__m128i pixel) {
+		const __m128 p = _mm_cvtepi32_ps(pixel);
+		const __m128 a = _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 3, 3));
+		const __m128 color = _mm_div_ps(_mm_mul_ps(p, max), _mm_max_ps(a, one));
+		// Transparent pixels are black, as in the scalar path.
+		const __m128 opaque = _mm_cmpgt_ps(a, _mm_setzero_ps());
+		const __m128 rounded = _mm_and_ps(_mm_min_ps(_mm_add_ps(color, half), max), opaque);
+		return _mm_cvttps_epi32(_mm_or_ps(_mm_and_ps(color_lanes, rounded), _mm_andnot_ps(color_lanes, p)));
+	};
+	for (; x + 4 <= width; x += 4) {
+		const __m128i pixels = _mm_loadu_si128((const __m128i *)(src + x * 4));
+		const __m128i lo = _mm_unpacklo_epi8(pixels, zero);
+		const __m128i hi = _mm_unpackhi_epi8(pixels, zero);
+		const __m128i p0 = unpremultiply_pixel(_mm_unpacklo_epi16(lo, zero));
+		const __m128i p1 = unpremultiply_pixel(_mm_unpackhi_epi16(lo, zero));
+		const __m128i p2 = unpremultiply_pixel(_mm_unpacklo_epi16(hi, zero));
+		const __m128i p3 = unpremultiply_pixel(_mm_unpackhi_epi16(hi, zero));
+		_mm_storeu_si128((__m128i *)(dst + x * 4),
+				 _mm_packus_epi16(_mm_packs_epi32(p0, p1), _mm_packs_epi32(p2, p3)));
+	}
+#elif defined(NDI_VIDEO_CONVERT_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+	// 8 pixels per iteration, deinterleaved into B, G, R and A vectors.
+	const float32x4_t zero = vdupq_n_f32(0.0f);
+	const float32x4_t one = vdupq_n_f32(1.0f);
+	const float32x4_t half = vdupq_n_f32(0.5f);
+	const float32x4_t max = vdupq_n_f32(255.0f);
+	for (; x + 8 <= width; x += 8) {
+		uint8x8x4_t pixels = vld4_u8(src + x * 4);
+		const uint16x8_t a = vmovl_u8(pixels.val[3]);
+		const float32x4_t a_lo = vcvtq_f32_u32(vmovl_u16(vget_low_u16(a)));
+		const float32x4_t a_hi = vcvtq_f32_u32(vmovl_u16(vget_high_u16(a)));
+		const float32x4_t divisor_lo = vmaxq_f32(a_lo, one);
+		const float32x4_t divisor_hi = vmaxq_f32(a_hi, one);
+		// Transparent pixels are black, as in the scalar path.
+		const uint32x4_t opaque_lo = vcgtq_f32(a_lo, zero);
+		const uint32x4_t opaque_hi = vcgtq_f32(a_hi, zero);
+		for (int c = 0; c < 3; ++c) {
+			const uint16x8_t color = vmovl_u8(pixels.val[c]);
+			const float32x4_t color_lo = vcvtq_f32_u32(vmovl_u16(vget_low_u16(color)));
+			const float32x4_t color_hi = vcvtq_f32_u32(vmovl_u16(vget_high_u16(color)));
+			const float32x4_t straight_lo = vdivq_f32(vmulq_f32(color_lo, max), divisor_lo);
+			const float32x4_t straight_hi = vdivq_f32(vmulq_f32(color_hi, max), divisor_hi);
+			const uint32x4_t lo = vandq_u32(vcvtq_u32_f32(vminq_f32(vaddq_f32(straight_lo, half), max)),
+							opaque_lo);
+			const uint32x4_t hi = vandq_u32(vcvtq_u32_f32(vminq_f32(vaddq_f32(straight_hi, half), max)),
+							opaque_hi);
+			pixels.val[c] = vmovn_u16(vcombine_u16(vmovn_u32(lo), vmovn_u32(hi)));
+		}
+		vst4_u8(dst + x * 4, pixels);
+	}
+#endif
+	unpremultiply_bgra_pixels(src, dst, x, width);
+}
+
+#ifndef NDEBUG
+//
+// Debug builds check once that the SIMD path matches the scalar one for every color and alpha value.
+//
+static void unpremultiply_bgra_check()
+{
+	const uint32_t count = 256 * 256;
+	std::vector<uint8_t> src(count * 4), simd(count * 4), scalar(count * 4);
+	for (uint32_t i = 0; i < count; ++i) {
+		src[i * 4] = (uint8_t)i;
+		src[i * 4 + 1] = (uint8_t)(255 - i);
+		src[i * 4 + 2] = (uint8_t)(i * 7);
+		src[i * 4 + 3] = (uint8_t)(i >> 8);
+	}
+	unpremultiply_bgra_row(src.data(), simd.data(), count);
+	unpremultiply_bgra_pixels(src.data(), scalar.data(), 0, count);
+	if (simd != scalar)
+		obs_log(LOG_WARNING, "ndi_video_unpremultiply_bgra: SIMD and scalar results differ");
+}
+#endif
+
+void ndi_video_unpremultiply_bgra(const uint8_t *src, size_t src_linesize, uint8_t *dst, size_t dst_linesize,
+				  uint32_t width, uint32_t height)
+{
+#ifndef NDEBUG
+	static std::once_flag checked;
+	std::call_once(checked, unpremultiply_bgra_check);
+#endif
+	for (uint32_t row = 0; row < height; ++row) {
+		unpremultiply_bgra_row(src + row * src_linesize, dst + row * dst_linesize, width);
+	}
+}
+
+//
+// Premultiplied YUV scales the distance to black (luma) or to grey (chroma) by the alpha.
+// Scalar: 16.16 fixed point reciprocals of the alpha values avoid a division per sample, and the per-sample
+// table lookups do not vectorize with SSE2 or NEON. Fully transparent pixels become black (grey chroma).
+//
+static inline uint8_t unpremultiply_offset(uint8_t c, int offset, uint32_t reciprocal)
+{
+	const int value = offset + (int)(((int64_t)(c - offset) * reciprocal + 32768) >> 16);
+	return (uint8_t)std::clamp(value, 0, 255);
+}
+
+void ndi_video_unpremultiply_i422(uint8_t *y, size_t y_linesize, uint8_t *u, uint8_t *v, size_t uv_linesize,
+				  const uint8_t *alpha, size_t alpha_linesize, uint32_t width, uint32_t height,
+				  bool full_range)
+{
+	static const auto reciprocals = [] {
+		std::array<uint32_t, 256> table{};
+		for (uint32_t a = 1; a < 256; ++a)
+			table[a] = (255u * 65536u + a / 2) / a;
+		return table;
+	}();
+	const int black = full_range ? 0 : 16;
+
+	for (uint32_t row = 0; row < height; ++row) {
+		uint8_t *y_row = y + row * y_linesize;
+		uint8_t *u_row = u + row * uv_linesize;
+		uint8_t *v_row = v + row * uv_linesize;
+		const uint8_t *a_row = alpha + row * alpha_linesize;
+		for (uint32_t x = 0; x + 2 <= width; x += 2) {
+			const uint8_t a0 = a_row[x];
+			const uint8_t a1 = a_row[x + 1];
+			y_row[x] = unpremultiply_offset(y_row[x], black, reciprocals[a0]);
+			y_row[x + 1] = unpremultiply_offset(y_row[x + 1], black, reciprocals[a1]);
+			const uint32_t chroma_reciprocal = reciprocals[(a0 + a1 + 1) / 2];
+			u_row[x / 2] = unpremultiply_offset(u_row[x / 2], 128, chroma_reciprocal);
+			v_row[x / 2] = unpremultiply_offset(v_row[x / 2], 128, chroma_reciprocal);
+		}
+	}
+}
+
+#if defined(NDI_VIDEO_CONVERT_SSE2)
+//
+// Splits 32 bytes into their even and odd groups of 1, 2 or 4 bytes, 16 bytes each.
+//
+static inline void split_group1(__m128i a, __m128i b, __m128i *even, __m128i *odd)
+{
+	const __m128i low_bytes = _mm_set1_epi16(0x00ff);
+	*even = _mm_packus_epi16(_mm_and_si128(a, low_bytes), _mm_and_si128(b, low_bytes));
+	*odd = _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+}
+
+static inline void split_group2(__m128i a, __m128i b, __m128i *even, __m128i *odd)
+{
+	// Gather the even 16-bit words in the low half and the odd ones in the high half.
+	auto split = [](__m128i x) {
+		x = _mm_shufflelo_epi16(x, _MM_SHUFFLE(3, 1, 2, 0));
+		x = _mm_shufflehi_epi16(x, _MM_SHUFFLE(3, 1, 2, 0));
+		return _mm_shuffle_epi32(x, _MM_SHUFFLE(3, 1, 2, 0));
+	};
+	const __m128i sa = split(a);
+	const __m128i sb = split(b);
+	*even = _mm_unpacklo_epi64(sa, sb);
+	*odd = _mm_unpackhi_epi64(sa, sb);
+}
+
+static inline void split_group4(__m128i a, __m128i b, __m128i *even, __m128i *odd)
+{
+	const __m128 fa = _mm_castsi128_ps(a);
+	const __m128 fb = _mm_castsi128_ps(b);
+	*even = _mm_castps_si128(_mm_shuffle_ps(fa, fb, _MM_SHUFFLE(2, 0, 2, 0)));
+	*odd = _mm_castps_si128(_mm_shuffle_ps(fa, fb, _MM_SHUFFLE(3, 1, 3, 1)));
+}
+
+static inline void split_group(size_t group, __m128i a, __m128i b, __m128i *even, __m128i *odd)
+{
+	if (group == 1)
+		split_group1(a, b, even, odd);
+	else if (group == 2)
+		split_group2(a, b, even, odd);
+	else
+		split_group4(a, b, even, odd);
+}
+
+//
+// (a + b + c + d + 2) / 4 per byte, in 16 bits so that it rounds like the scalar path.
+//
+static inline __m128i average4(__m128i a, __m128i b, __m128i c, __m128i d)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i two = _mm_set1_epi16(2);
+	const __m128i lo = _mm_add_epi16(_mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero)),
+					 _mm_add_epi16(_mm_unpacklo_epi8(c, zero), _mm_unpacklo_epi8(d, zero)));
+	const __m128i hi = _mm_add_epi16(_mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero)),
+					 _mm_add_epi16(_mm_unpackhi_epi8(c, zero), _mm_unpackhi_epi8(d, zero)));
+	return _mm_packus_epi16(_mm_srli_epi16(_mm_add_epi16(lo, two), 2), _mm_srli_epi16(_mm_add_epi16(hi, two), 2));
+}
+#elif defined(NDI_VIDEO_CONVERT_NEON)
+//
+// Splits 32 bytes into their even (val[0]) and odd (val[1]) groups of 1, 2 or 4 bytes, 16 bytes each.
+//
+static inline uint8x16x2_t split_group(size_t group, uint8x16_t a, uint8x16_t b)
+{
+	if (group == 1)
+		return vuzpq_u8(a, b);
+
+	uint8x16x2_t split;
+	if (group == 2) {
+		const uint16x8x2_t words = vuzpq_u16(vreinterpretq_u16_u8(a), vreinterpretq_u16_u8(b));
+		split.val[0] = vreinterpretq_u8_u16(words.val[0]);
+		split.val[1] = vreinterpretq_u8_u16(words.val[1]);
+	} else {
+		const uint32x4x2_t words = vuzpq_u32(vreinterpretq_u32_u8(a), vreinterpretq_u32_u8(b));
+		split.val[0] = vreinterpretq_u8_u32(words.val[0]);
+		split.val[1] = vreinterpretq_u8_u32(words.val[1]);
+	}
+	return split;
+}
+
+//
+// (a + b + c + d + 2) / 4 per byte, in 16 bits so that it rounds like the scalar path.
+//
+static inline uint8x8_t average4(uint8x8_t a, uint8x8_t b, uint8x8_t c, uint8x8_t d)
+{
+	return vrshrn_n_u16(vaddq_u16(vaddl_u8(a, b), vaddl_u8(c, d)), 2);
+}
+
+static inline uint8x16_t average4(uint8x16_t a, uint8x16_t b, uint8x16_t c, uint8x16_t d)
+{
+	return vcombine_u8(average4(vget_low_u8(a), vget_low_u8(b), vget_low_u8(c), vget_low_u8(d)),
+			   average4(vget_high_u8(a), vget_high_u8(b), vget_high_u8(c), vget_high_u8(d)));
+}
+#endif
+
+static void downscale2_row(const uint8_t *row0, const uint8_t *row1, uint8_t *dst, size_t dst_bytes, size_t group)
+{
+	size_t i = 0;
+#if defined(NDI_VIDEO_CONVERT_SSE2)
+	for (; i + 16 <= dst_bytes; i += 16) {
+		__m128i even0, odd0, even1, odd1;
+		split_group(group, _mm_loadu_si128((const __m128i *)(row0 + i * 2)),
+			    _mm_loadu_si128((const __m128i *)(row0 + i * 2 + 16)), &even0, &odd0);
+		split_group(group, _mm_loadu_si128((const __m128i *)(row1 + i * 2)),
+			    _mm_loadu_si128((const __m128i *)(row1 + i * 2 + 16)), &even1, &odd1);
+		_mm_storeu_si128((__m128i *)(dst + i), average4(even0, odd0, even1, odd1));
+	}
+#elif defined(NDI_VIDEO_CONVERT_NEON)
+	for (; i + 16 <= dst_bytes; i += 16) {
+		const uint8x16x2_t split0 = split_group(group, vld1q_u8(row0 + i * 2), vld1q_u8(row0 + i * 2 + 16));
+		const uint8x16x2_t split1 = split_group(group, vld1q_u8(row1 + i * 2), vld1q_u8(row1 + i * 2 + 16));
+		vst1q_u8(dst + i, average4(split0.val[0], split0.val[1], split1.val[0], split1.val[1]));
+	}
+#endif
+	for (; i < dst_bytes; ++i) {
+		const size_t src = (i / group) * group * 2 + i % group;
+		dst[i] = (uint8_t)((row0[src] + row0[src + group] + row1[src] + row1[src + group] + 2) / 4);
+	}
+}
+
+void ndi_video_downscale2_plane(const uint8_t *src, size_t src_linesize, uint8_t *dst, size_t dst_linesize,
+				size_t dst_bytes, uint32_t dst_height, size_t group)
+{
+	for (uint32_t row = 0; row < dst_height; ++row) {
+		const uint8_t *row0 = src + (size_t)row * 2 * src_linesize;
+		downscale2_row(row0, row0 + src_linesize, dst + row * dst_linesize, dst_bytes, group);
+	}
+}
+
+static void downscale2_uyvy_row(const uint8_t *row0, const uint8_t *row1, uint8_t *dst, uint32_t dst_width)
+{
+	uint32_t x = 0;
+#if defined(NDI_VIDEO_CONVERT_SSE2)
+	// 16 source pixels (32 bytes) into 8 pixels: the luma samples and the UV pairs of each row are split into
+	// even and odd ones, averaged over both rows, then re-interleaved.
+	const __m128i low_bytes = _mm_set1_epi16(0x00ff);
+	const __m128i zero = _mm_setzero_si128();
+	for (; x + 8 <= dst_width; x += 8) {
+		const uint8_t *rows[2] = {row0 + x * 4, row1 + x * 4};
+		__m128i luma_even[2], luma_odd[2], chroma_even[2], chroma_odd[2];
+		for (int r = 0; r < 2; ++r) {
+			const __m128i a = _mm_loadu_si128((const __m128i *)rows[r]);
+			const __m128i b = _mm_loadu_si128((const __m128i *)(rows[r] + 16));
+			const __m128i luma = _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+			const __m128i chroma =
+				_mm_packus_epi16(_mm_and_si128(a, low_bytes), _mm_and_si128(b, low_bytes));
+			split_group1(luma, zero, &luma_even[r], &luma_odd[r]);
+			split_group2(chroma, zero, &chroma_even[r], &chroma_odd[r]);
+		}
+		const __m128i luma_half = average4(luma_even[0], luma_odd[0], luma_even[1], luma_odd[1]);
+		const __m128i chroma_half = average4(chroma_even[0], chroma_odd[0], chroma_even[1], chroma_odd[1]);
+		_mm_storeu_si128((__m128i *)(dst + x * 2), _mm_unpacklo_epi8(chroma_half, luma_half));
+	}
+#elif defined(NDI_VIDEO_CONVERT_NEON)
+	// Same as SSE2: vld2 splits chroma (val[0]) from luma (val[1]), vst2 re-interleaves them.
+	for (; x + 8 <= dst_width; x += 8) {
+		const uint8x16x2_t s0 = vld2q_u8(row0 + x * 4);
+		const uint8x16x2_t s1 = vld2q_u8(row1 + x * 4);
+		const uint8x8x2_t luma0 = vuzp_u8(vget_low_u8(s0.val[1]), vget_high_u8(s0.val[1]));
+		const uint8x8x2_t luma1 = vuzp_u8(vget_low_u8(s1.val[1]), vget_high_u8(s1.val[1]));
+		const uint16x4x2_t chroma0 = vuzp_u16(vreinterpret_u16_u8(vget_low_u8(s0.val[0])),
+						      vreinterpret_u16_u8(vget_high_u8(s0.val[0])));
+		const uint16x4x2_t chroma1 = vuzp_u16(vreinterpret_u16_u8(vget_low_u8(s1.val[0])),
+						      vreinterpret_u16_u8(vget_high_u8(s1.val[0])));
+		uint8x8x2_t halved;
+		halved.val[0] = average4(vreinterpret_u8_u16(chroma0.val[0]), vreinterpret_u8_u16(chroma0.val[1]),
+					 vreinterpret_u8_u16(chroma1.val[0]), vreinterpret_u8_u16(chroma1.val[1]));
+		halved.val[1] = average4(luma0.val[0], luma0.val[1], luma1.val[0], luma1.val[1]);
+		vst2_u8(dst + x * 2, halved);
+	}
+#endif
+	for (; x + 2 <= dst_width; x += 2) {
+		// Output pixels x and x + 1 come from the source pixels 2x to 2x + 3 (macropixels x and x + 1).
+		const uint8_t *p0 = row0 + x * 4;
+		const uint8_t *p1 = row1 + x * 4;
+		uint8_t *q = dst + x * 2;
+		q[0] = (uint8_t)((p0[0] + p0[4] + p1[0] + p1[4] + 2) / 4);
+		q[1] = (uint8_t)((p0[1] + p0[3] + p1[1] + p1[3] + 2) / 4);
+		q[2] = (uint8_t)((p0[2] + p0[6] + p1[2] + p1[6] + 2) / 4);
+		q[3] = (uint8_t)((p0[5] + p0[7] + p1[5] + p1[7] + 2) / 4);
+	}
+}
+
+void ndi_video_downscale2_uyvy(const uint8_t *src, size_t src_linesize, uint8_t *dst, size_t dst_linesize,
+			       uint32_t dst_width, uint32_t dst_height)
+{
+	for (uint32_t row = 0; row < dst_height; ++row) {
+		const uint8_t *row0 = src + (size_t)row * 2 * src_linesize;
+		downscale2_uyvy_row(row0, row0 + src_linesize, dst + row * dst_linesize, dst_width);
+	}
+}
+
+//
+// Worker pool of `ndi_video_parallel_for`. Jobs are queued so that several sources can convert frames at the same
+// time; the calling thread always works on its own job, so a job completes even if every worker is busy.
+//
+struct ParallelJob {
+	const std::function<void(uint32_t, uint32_t)> *function;
+	uint32_t count;
+	uint32_t band;
+	uint32_t next;
+	uint32_t pending;
+};
+
+static std::vector<std::thread> parallel_workers;
+static std::deque<ParallelJob *> parallel_jobs;
+static std::mutex parallel_mutex;
+static std::condition_variable parallel_job_queued;
+static std::condition_variable parallel_job_done;
+static bool parallel_stopping = false;
+
+static bool parallel_run_band(ParallelJob *job, std::unique_lock<std::mutex> &lock)
+{
+	if (job->next >= job->count)
+		return false;
+
+	const uint32_t begin = job->next;
+	const uint32_t end = std::min(job->count, begin + job->band);
+	job->next = end;
+	if (job->next >= job->count)
+		parallel_jobs.erase(std::find(parallel_jobs.begin(), parallel_jobs.end(), job));
+
+	lock.unlock();
+	(*job->function)(begin, end);
+	lock.lock();
+
+	job->pending -= end - begin;
+	if (job->pending == 0)
+		parallel_job_done.notify_all();
+	return true;
+}
+
+static void parallel_worker_loop()
+{
+	os_set_thread_name("distroav-video-convert");
+
+	std::unique_lock<std::mutex> lock(parallel_mutex);
+	while (!parallel_stopping) {
+		if (parallel_jobs.empty()) {
+			parallel_job_queued.wait(lock);
+			continue;
+		}
+		parallel_run_band(parallel_jobs.front(), lock);
+	}
+}
+
+void ndi_video_parallel_for(uint32_t count, const std::function<void(uint32_t begin, uint32_t end)> &function)
+{
+	std::unique_lock<std::mutex> lock(parallel_mutex);
+
+	if (parallel_workers.empty() && !parallel_stopping) {
+		// The calling thread works too; keep a core for OBS.
+		const int worker_count = std::clamp(os_get_logical_cores() - 2, 1, 7);
+		for (int i = 0; i < worker_count; ++i) {
+			parallel_workers.emplace_back(parallel_worker_loop);
+		}
+		obs_log(LOG_INFO, "ndi_video_parallel_for: started %d video conversion threads", worker_count);
+	}
+
+	// Two bands per thread balance the load without much scheduling overhead.
+	const uint32_t bands = (uint32_t)(parallel_workers.size() + 1) * 2;
+	ParallelJob job = {&function, count, std::max(1u, (count + bands - 1) / bands), 0, count};
+	if (count == 0)
+		return;
+	parallel_jobs.push_back(&job);
+	parallel_job_queued.notify_all();
+
+	while (parallel_run_band(&job, lock)) {
+	}
+	parallel_job_done.wait(lock, [&job] { return job.pending == 0; });
+}
+
+void ndi_video_convert_shutdown()
+{
+	{
+		std::lock_guard<std::mutex> lock(parallel_mutex);
+		parallel_stopping = true;
+		parallel_job_queued.notify_all();
+	}
+
+	for (auto &worker : parallel_workers) {
+		worker.join();
+	}
+
+	std::lock_guard<std::mutex> lock(parallel_mutex);
+	parallel_workers.clear();
+	parallel_stopping = false;
+}
@@ -0,0 +1,57 @@
+/******************************************************************************
+	Copyright (C) 2016-2024 DistroAV <contact@distroav.org>
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+//
+// Pixel format conversions of received NDI frames into formats OBS takes natively.
+//
+
+// Deinterleaves `height` rows of packed UYVY 4:2:2 into planar Y, U and V (I422). `width` must be even.
+void ndi_video_uyvy_to_i422(const uint8_t *src, size_t src_linesize, uint8_t *dst_y, size_t dst_y_linesize,
+			    uint8_t *dst_u, uint8_t *dst_v, size_t dst_uv_linesize, uint32_t width, uint32_t height);
+
+// Converts `height` rows of premultiplied BGRA (or RGBA) to straight alpha. `src` and `dst` may be the same.
+void ndi_video_unpremultiply_bgra(const uint8_t *src, size_t src_linesize, uint8_t *dst, size_t dst_linesize,
+				  uint32_t width, uint32_t height);
+
+// Converts premultiplied planar YUV 4:2:2 (I422 planes + full resolution alpha plane) to straight alpha, in place.
+// `full_range` selects the luma black level (0 or 16); the chroma of a pixel pair uses their average alpha.
+void ndi_video_unpremultiply_i422(uint8_t *y, size_t y_linesize, uint8_t *u, uint8_t *v, size_t uv_linesize,
+				  const uint8_t *alpha, size_t alpha_linesize, uint32_t width, uint32_t height,
+				  bool full_range);
+
+// Halves the resolution of a plane of 8-bit samples with a 2x2 box filter. `group` is the size in bytes of the
+// samples averaged together: 1 for a plane of single samples, 2 for interleaved UV, 4 for BGRA.
+// `dst_bytes` is the size of a destination row in bytes; source rows are read in pairs.
+void ndi_video_downscale2_plane(const uint8_t *src, size_t src_linesize, uint8_t *dst, size_t dst_linesize,
+				size_t dst_bytes, uint32_t dst_height, size_t group);
+
+// Halves the resolution of packed UYVY 4:2:2. `dst_width` (in pixels) must be even.
+void ndi_video_downscale2_uyvy(const uint8_t *src, size_t src_linesize, uint8_t *dst, size_t dst_linesize,
+			       uint32_t dst_width, uint32_t dst_height);
+
+// Runs `function(begin, end)` over bands of [0, count) on a shared pool of worker threads and on the calling
+// thread, and returns once all the bands are done.
+void ndi_video_parallel_for(uint32_t count, const std::function<void(uint32_t begin, uint32_t end)> &function);
+
+// Stops the worker threads of `ndi_video_parallel_for`.
+void ndi_video_convert_shutdown();
@@ -22,6 +22,11 @@
 #include "forms/output-settings.h"
 #include "forms/update.h"
 #include "main-output.h"
+#include "ndi-capture-clock.h"
+#include "ndi-finder.h"
+#include "ndi-receive-engine.h"
+#include "ndi-receiver-pool.h"
+#include "ndi-video-convert.h"
 #include "preview-output.h"
 
 #include <QAction>
@@ -34,6 +39,8 @@
 #include <QRegularExpression>
 #include <QTimer>
 
+#include <vector>
+
 OBS_DECLARE_MODULE()
 OBS_MODULE_USE_DEFAULT_LOCALE(PLUGIN_NAME, "en-US")
 
@@ -49,9 +56,13 @@ const char *obs_module_description()
 
 const NDIlib_v6 *ndiLib = nullptr;
 static bool plugin_features_registered = false;
+// Set once OBS starts shutting down, before it cleans up the scene collection.
+static bool obs_exiting = false;
 
 extern struct obs_source_info create_ndi_source_info();
 struct obs_source_info ndi_source_info;
+extern void ndi_source_stop_all();
+extern void ndi_source_preconnect_scenes(const std::vector<obs_source_t *> &scenes, int budget);
 
 extern struct obs_output_info create_ndi_output_info();
 struct obs_output_info ndi_output_info;
@@ -282,6 +293,46 @@ static void register_plugin_features()
 	obs_log(LOG_DEBUG, "-register_plugin_features()");
 }
 
+//
+// Pre-connects the receivers of the NDI sources in the scenes most likely to be shown next: in studio mode the
+// preview scene and the one after it in the scene list, otherwise the scene after the program scene.
+//
+static void preconnect_next_scenes()
+{
+	const int budget = Config::Current()->PreconnectReceivers;
+	if (budget <= 0) {
+		ndi_source_preconnect_scenes({}, 0);
+		return;
+	}
+
+	const bool studio_mode = obs_frontend_preview_program_mode_active();
+	auto current_scene = studio_mode ? obs_frontend_get_current_preview_scene() : obs_frontend_get_current_scene();
+	if (!current_scene) {
+		ndi_source_preconnect_scenes({}, budget);
+		return;
+	}
+
+	std::vector<obs_source_t *> next_scenes;
+	if (studio_mode)
+		next_scenes.push_back(current_scene);
+
+	struct obs_frontend_source_list scenes = {};
+	obs_frontend_get_scenes(&scenes);
+	for (size_t i = 0; i < scenes.sources.num; i++) {
+		if (scenes.sources.array[i] == current_scene) {
+			auto next_scene = scenes.sources.array[(i + 1) % scenes.sources.num];
+			if (next_scene != current_scene)
+				next_scenes.push_back(next_scene);
+			break;
+		}
+	}
+
+	ndi_source_preconnect_scenes(next_scenes, budget);
+
+	obs_frontend_source_list_free(&scenes);
+	obs_source_release(current_scene);
+}
+
 bool obs_module_load(void)
 {
 	obs_log(LOG_DEBUG, "+obs_module_load()");
@@ -477,12 +528,46 @@ bool obs_module_load(void)
 						[] {
 							main_output_init();
 							preview_output_init();
+							preconnect_next_scenes();
 						},
 						Qt::QueuedConnection);
 				} else if (event == OBS_FRONTEND_EVENT_EXIT) {
 					// Unknown why putting this in obs_module_unload causes a crash when closing OBS
 					main_output_deinit();
 					preview_output_deinit();
+					if (plugin_features_registered) {
+						NDIReceiverPool::StopParking();
+						ndi_source_stop_all();
+						NDIReceiverPool::DestroyParked();
+					}
+				} else if (event == OBS_FRONTEND_EVENT_SCRIPTING_SHUTDOWN) {
+					// Sent before the scene collection cleanup when OBS exits.
+					obs_exiting = true;
+				} else if (event == OBS_FRONTEND_EVENT_SCENE_COLLECTION_CLEANUP) {
+					// Stop all receivers at once before OBS destroys the sources one by one, and
+					// keep them connected for the sources of the next scene collection, unless
+					// OBS is exiting.
+					if (plugin_features_registered) {
+						if (!obs_exiting)
+							NDIReceiverPool::StartParking();
+						ndi_source_stop_all();
+					}
+				} else if (event == OBS_FRONTEND_EVENT_SCENE_COLLECTION_CHANGED) {
+					// The sources of the new collection may still be creating their receivers: give
+					// them a few seconds to take over the parked ones.
+					if (plugin_features_registered) {
+						NDIReceiverPool::StopParking();
+						QTimer::singleShot(5000, [] { NDIReceiverPool::DestroyParked(); });
+					}
+				} else if (event == OBS_FRONTEND_EVENT_SCENE_CHANGED ||
+					   event == OBS_FRONTEND_EVENT_PREVIEW_SCENE_CHANGED ||
+					   event == OBS_FRONTEND_EVENT_SCENE_LIST_CHANGED ||
+					   event == OBS_FRONTEND_EVENT_STUDIO_MODE_ENABLED ||
+					   event == OBS_FRONTEND_EVENT_STUDIO_MODE_DISABLED) {
+					// The scene changes when a transition starts, so the next scene is
+					// pre-connected while the transition runs.
+					if (plugin_features_registered)
+						preconnect_next_scenes();
 				} else if (event == OBS_FRONTEND_EVENT_PROFILE_CHANGING) {
 					main_output_deinit();
 					preview_output_deinit();
@@ -520,6 +605,12 @@ void obs_module_unload(void)
 
 	updateCheckStop();
 
+	NDICaptureClock::Shutdown();
+	NDIReceiveEngine::Shutdown();
+	NDIFinder::shutdown();
+	NDIReceiverPool::DestroyParked(true);
+	ndi_video_convert_shutdown();
+
 	if (ndiLib) {
 		ndiLib->destroy();
 		ndiLib = nullptr;